@@ -1,6 +1,22 @@
 #pragma once
 
 #include <IFractal.hpp>
+#include <Image.hpp>
+#include <Uniform.hpp>
+#include <cpu/CpuRenderer.hpp>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Where the escape-time of each pixel is computed.
+ */
+enum class RenderBackend {
+    // Escape-time loop inside of the FragmentShader
+    GPU,
+    // Escape-time loop on all CPU cores (IFractal::computeIterations), the result is uploaded as a texture
+    CPU
+};
 
 /**
  * Abstract Class acts as the Base of every Concrete Fractal.
@@ -19,7 +35,7 @@ class BaseFractal : public IFractal {
         ~BaseFractal();
 
         /**
-         * Initialize a Fullscreen OpenGL window.
+         * Initialize a Fullscreen OpenGL window, or only an OpenGL context (see setHeadless).
          *
          * @param p_windowTitle Title of the window.
          *
@@ -29,7 +45,7 @@ class BaseFractal : public IFractal {
         void initializeWindow(const std::string &p_windowTitle) override;
 
         /**
-         * Create a ShaderProgram.
+         * Create a ShaderProgram and resolve the locations of all registered uniforms.
          * The vertexShader should be identical for all Fractals and thus doesnt need to be dynamic.
          *
          * @throws ShaderError if one of the shaders contain errors.
@@ -44,13 +60,149 @@ class BaseFractal : public IFractal {
 
         /**
          * Render the Fractal.
+         *
+         * With render on demand (default), a frame is only drawn after requestRedraw, otherwise the loop sleeps in
+         * glfwWaitEvents until the next input event arrives.
+         *
+         * Progressive rendering (default) draws every requested frame at 1/8 of the resolution first. Only once no
+         * further redraw is requested, the image is refined at 1/4, 1/2 and full resolution, one pass per iteration
+         * of the loop. The passes are rendered to an offscreen target and scaled up to the window.
          */
         void renderFractal() override;
 
+        /**
+         * Render without a window, e.g. on machines without a display or GPU. Call it before initializeWindow.
+         *
+         * The context is created surfaceless via EGL, with the OSMesa software rasterizer (llvmpipe) as fallback, and
+         * frames are only drawn into the offscreen targets, see captureFrame. Without a display this requires GLFW 3.4
+         * (null platform), older versions create an invisible window instead.
+         */
+        void setHeadless(bool p_headless) { _headless = p_headless; }
+
+        /**
+         * Draw the current view at full resolution into the offscreen target and read it back.
+         * Works with and without a window, the image is shown by the next iteration of the render loop.
+         *
+         * @return The frame.
+         */
+        Image captureFrame();
+
+        /**
+         * Enable or disable progressive rendering (only in effect with render on demand).
+         */
+        void setProgressive(bool p_progressive) { _progressive = p_progressive; }
+
+        /**
+         * Switch between render on demand and redrawing every iteration of the render loop.
+         */
+        void setRenderOnDemand(bool p_renderOnDemand) { _renderOnDemand = p_renderOnDemand; }
+
+        /**
+         * Select, where the fractal is computed. Can be changed between frames.
+         */
+        void setBackend(RenderBackend p_backend) {
+            _backend = p_backend;
+            requestRedraw();
+        }
+
+        /**
+         * @return The currently selected backend.
+         */
+        RenderBackend getBackend() const { return _backend; }
+
+        /**
+         * Enable or disable solid guessing on the GPU backend (off by default).
+         *
+         * Every pass is preceded by a chain of coarse iteration levels at 1/8, 1/4 and 1/2 of its resolution. The
+         * coarsest level is computed, each finer one only computes the pixels whose 3x3 neighbourhood on the next
+         * coarser level differs and writes the common count everywhere else. Features thinner than a coarse pixel
+         * may be lost.
+         *
+         * The fragment shader takes part through u_guessPass (0: compute, 1: guess or compute, 2: guessed pixels only,
+         * discarding the others), u_coarseIterations (usampler2D of the next coarser level, half of u_resolution) and
+         * writes the iteration count to output location 1.
+         */
+        void setSolidGuessing(bool p_enabled) {
+            _solidGuessing = p_enabled;
+            requestRedraw();
+        }
+        bool getSolidGuessing() const { return _solidGuessing; }
+
+        /**
+         * Counts on the GPU and waits for the result, only meant for statistics.
+         *
+         * @return Fraction of the pixels of the last pass, which were guessed (0, if it was drawn without guessing).
+         */
+        double getGuessedFraction();
+
+        /**
+         * No cache by default, the GPU backend always computes.
+         */
+        bool lookupIterations(IterationBuffer & /*p_buffer*/, const std::vector<Tile> & /*p_regions*/) override {
+            return false;
+        }
+
     protected:
+        /**
+         * Draw the next frame. Call it from doOnRenderStart, whenever the view changed, and every frame while an
+         * animation is running. The loop keeps polling while redraws are requested, so held keys stay smooth.
+         */
+        void requestRedraw() { _redrawRequested = true; }
+
+        /**
+         * The view has only been translated by whole pixels (of the full resolution) since the last frame.
+         * If the last image is complete, it's shifted and only the exposed strips are computed, otherwise this falls
+         * back to requestRedraw.
+         *
+         * @param p_dx Pixels the view moved to the right.
+         * @param p_dy Pixels the view moved up.
+         */
+        void requestPan(int p_dx, int p_dy);
+
+        /**
+         * The view has only been scaled around its center since the last frame (new width = old width * p_factor).
+         *
+         * The last image is shown rescaled right away and only refined once the zoom settles. It's recomputed at
+         * 1/4 of the resolution when stretched more than 2x. Zooming out by an odd integer factor on the CPU backend
+         * reuses the iteration counts of the pixels landing on previous sample centers (see IterationBuffer::shrink).
+         */
+        void requestZoom(double p_factor);
+
+        /**
+         * Resolution of the pass being rendered (see setProgressive), use it instead of _width / _height for
+         * u_resolution and the pixel size in setUniforms. The CPU backend receives a buffer of this size.
+         */
+        int getRenderWidth() const { return _renderWidth; }
+        int getRenderHeight() const { return _renderHeight; }
+
+        /**
+         * @return Whether the pass being drawn shows the uploaded iteration counts (CPU backend, or a successful
+         *         lookupIterations), i.e. the value of u_backend in setUniforms.
+         */
+        bool usesIterationTexture() const { return _iterationTextureUsed; }
+
+        /**
+         * The CPU renderer is created on first use, so the GPU path doesn't spawn any worker threads.
+         *
+         * @return The CPU renderer shared by all frames.
+         */
+        CpuRenderer& getCpuRenderer();
+
+        /**
+         * Upload doubles to a buffer texture (usamplerBuffer, GL_RGBA32UI).
+         * Each texel holds two doubles, which the shader restores with packDouble2x32(texel.xy) / (texel.zw).
+         *
+         * @param p_textureUnit Texture unit the buffer texture is bound to (1 ... MAX_DOUBLE_BUFFERS).
+         * @param p_values The doubles (e.g. a reference orbit), the size must be even.
+         */
+        void uploadDoubleBuffer(int p_textureUnit, const std::vector<double> &p_values);
+
         // Shader Program (Protected to be able to access uniforms)
         GLuint _shaderProgram;
 
+        // Uniforms of the derived fractal register here, see Uniform
+        UniformRegistry _uniforms;
+
         // resolution
         const float _width = 1920;
         const float _height = 1080;
@@ -58,13 +210,94 @@ class BaseFractal : public IFractal {
         // Window
         GLFWwindow *_window;
 
+        RenderBackend _backend = RenderBackend::GPU;
+
     private:
+        // Show the last image again on window refresh events (expose, resize), the user pointer of the window is this
+        static void onWindowRefresh(GLFWwindow *p_window);
+
+        // Draw the fractal at 1 / 2^p_pass of the resolution into the offscreen target
+        void renderPass(int p_pass);
+
+        // Shift the last image by the requested pan and draw the exposed strips
+        void renderPan();
+
+        // Zoom out by an odd factor, reusing the matching iteration counts of the last full resolution CPU frame
+        void renderZoomReuse(int p_factor);
+
+        // Compute (CPU backend) p_computeRegions and draw p_drawRegions of the current offscreen target
+        void drawRegions(const std::vector<Tile> &p_computeRegions, const std::vector<Tile> &p_drawRegions);
+
+        // Draw p_regions through the coarse iteration levels (see setSolidGuessing), the program must be in use
+        void drawGuessed(const std::vector<Tile> &p_regions);
+
+        // Run the fragment shader inside of p_regions of the bound target
+        void drawQuad(const std::vector<Tile> &p_regions);
+
+        // Scale the last pass up to the window (applying a pending zoom preview) and swap the buffers
+        void present();
+
+        bool _headless = false;
+
+        // Render on demand state, the first frame is always drawn
+        bool _renderOnDemand = true;
+        bool _redrawRequested = true;
+        bool _presentRequested = false;
+
+        // Progressive rendering: next pass to draw (3: 1/8 ... 0: full resolution, -1: the image is complete)
+        static constexpr int COARSEST_PASS = 3;
+        bool _progressive = true;
+        int _nextPass = 0;
+        int _renderWidth = 0;
+        int _renderHeight = 0;
+
+        // Pan since the last frame (see requestPan)
+        int _panX = 0;
+        int _panY = 0;
+
+        // Zoom since the last computed image (see requestZoom), 1: none
+        static constexpr int ZOOM_PASS = 2;
+        double _zoomFactor = 1.0;
+        bool _zoomRequested = false;
+
+        // Offscreen targets of the passes, a pan shifts the image from the current into the other one
+        GLuint _framebuffers[2] = {};
+        GLuint _colorTextures[2] = {};
+        int _currentTarget = 0;
+
         // Buffer ID's
         GLuint _VAO, _VBO, _EBO;
 
         // Shader ID's
         GLuint _vertexShader, _fragmentShader;
 
+        // Result of the CPU backend, uploaded to an R32UI texture (bound to texture unit 0)
+        IterationBuffer _iterationBuffer;
+        GLuint _iterationTexture = 0;
+        bool _iterationTextureUsed = false;
+
+        // Buffer textures of uploadDoubleBuffer, indexed by texture unit - 1
+        static constexpr int MAX_DOUBLE_BUFFERS = 4;
+        GLuint _doubleBuffers[MAX_DOUBLE_BUFFERS] = {};
+        GLuint _doubleTextures[MAX_DOUBLE_BUFFERS] = {};
+
+        // Solid guessing: R32UI iteration counts at 1/2 ... 1/2^GUESS_LEVELS of the resolution (see setSolidGuessing)
+        static constexpr int GUESS_LEVELS = 3;
+        static constexpr int GUESS_TEXTURE_UNIT = MAX_DOUBLE_BUFFERS + 1;
+        bool _solidGuessing = false;
+        GLuint _guessFramebuffers[GUESS_LEVELS] = {};
+        GLuint _guessTextures[GUESS_LEVELS] = {};
+        Uniform<int> _guessPassUniform{_uniforms, "u_guessPass"};
+        Uniform<int> _coarseIterationsUniform{_uniforms, "u_coarseIterations"};
+
+        // Statistics of the last pass drawn with solid guessing, only counted on request (see getGuessedFraction)
+        GLuint _guessQuery = 0;
+        std::vector<Tile> _guessRegions;
+        bool _guessCounted = false;
+        uint64_t _guessedPixels = 0;
+
+        std::unique_ptr<CpuRenderer> _cpuRenderer;
+
         const char *_vertexShaderSource = R"(
             #version 330 core
             layout(location = 0) in vec2 aPos;
@@ -3,6 +3,11 @@
 #include <exception/ShaderError.hpp>
 #include <exception/WindowError.hpp>
 
+#include <cpu/IterationBuffer.hpp>
+#include <cpu/Tile.hpp>
+
+#include <vector>
+
 /**
  * Interface - Class.
  * Declares Core Methods, to support (Fractal)Rendering using OpenGL
@@ -55,6 +60,26 @@ class IFractal {
          */
         virtual void setUniforms() = 0;
 
+        /**
+         * Compute the iteration count of every pixel on the CPU.
+         * Used instead of the FragmentShader's escape-time loop, when the CPU backend is selected.
+         *
+         * @param p_buffer Destination, its size defines the resolution of the frame.
+         * @param p_regions The pixels to compute (the whole buffer, or the strips exposed by a pan), the rest of the
+         *                  buffer must be left untouched.
+         */
+        virtual void computeIterations(IterationBuffer& p_buffer, const std::vector<Tile>& p_regions) = 0;
+
+        /**
+         * Fill the regions with previously computed iteration counts, without computing anything.
+         * Lets the GPU backend skip its escape-time loop for areas that are already known. The counts may come from a
+         * cache with a different sampling (e.g. the nearest sample of a TileCache level), so they aren't necessarily
+         * pixel-identical to a direct render.
+         *
+         * @return false, if the counts aren't available (the buffer may be left untouched).
+         */
+        virtual bool lookupIterations(IterationBuffer& p_buffer, const std::vector<Tile>& p_regions) = 0;
+
         /**
          * Method will be executed each time a new frame is being rendered
          */
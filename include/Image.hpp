@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * A rendered frame, read back from the GPU (see BaseFractal::captureFrame).
+ */
+struct Image {
+        int width = 0;
+        int height = 0;
+
+        // RGB, 8 bits per channel, rows top-down
+        std::vector<uint8_t> pixels;
+};
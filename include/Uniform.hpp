@@ -0,0 +1,104 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * Type independent part of a Uniform, so the UniformRegistry can resolve all of them after linking.
+ */
+class UniformBase {
+    public:
+        virtual ~UniformBase() = default;
+
+        /**
+         * Look up the location in a freshly linked program. Forgets the last uploaded value.
+         */
+        virtual void resolve(GLuint p_program) = 0;
+
+    protected:
+        static void upload(GLint p_location, int p_value) { glUniform1i(p_location, p_value); }
+        static void upload(GLint p_location, float p_value) { glUniform1f(p_location, p_value); }
+
+        static void upload(GLint p_location, const std::array<float, 2>& p_value) {
+            glUniform2f(p_location, p_value[0], p_value[1]);
+        }
+
+        static void upload(GLint p_location, const std::vector<int>& p_value) {
+            glUniform1iv(p_location, static_cast<GLsizei>(p_value.size()), p_value.data());
+        }
+
+        /**
+         * Doubles are uploaded to uvec2 uniforms, the shader restores them with packDouble2x32. This avoids the
+         * precision loss of glUniform*f and doesn't require an OpenGL 4.0 context (glUniform*d).
+         */
+        static void upload(GLint p_location, double p_value) {
+            uint64_t bits;
+            std::memcpy(&bits, &p_value, sizeof(bits));
+            glUniform2ui(p_location, static_cast<GLuint>(bits & 0xFFFFFFFFu), static_cast<GLuint>(bits >> 32));
+        }
+};
+
+/**
+ * All uniforms of a shader program (see BaseFractal::_uniforms).
+ */
+class UniformRegistry {
+    public:
+        void add(UniformBase* p_uniform) { _uniforms.push_back(p_uniform); }
+
+        /**
+         * Resolve the locations of all registered uniforms, called once after the program has been linked.
+         */
+        void resolve(GLuint p_program) {
+            for (UniformBase* uniform : _uniforms) { uniform->resolve(p_program); }
+        }
+
+    private:
+        std::vector<UniformBase*> _uniforms;
+};
+
+/**
+ * A shader uniform with a cached location and value.
+ *
+ * Declared as a member of the fractal, next to the shader source:
+ * Uniform<int> _maxIterationsUniform{_uniforms, "u_maxIterations"};
+ * set() only calls glUniform*, if the value differs from the last upload (the program must be in use).
+ *
+ * @tparam T int, float, double (uvec2 in the shader), std::array<float, 2> (vec2) or std::vector<int> (int[]).
+ */
+template <typename T>
+class Uniform : public UniformBase {
+    public:
+        /**
+         * @param p_registry Registry of the fractal, resolves the location after linking.
+         * @param p_name Name in the shader source, must outlive the uniform (usually a string literal).
+         */
+        Uniform(UniformRegistry& p_registry, const char* p_name) : _name(p_name) { p_registry.add(this); }
+
+        // The registry holds a pointer to this
+        Uniform(const Uniform&) = delete;
+        Uniform& operator=(const Uniform&) = delete;
+
+        void resolve(GLuint p_program) override {
+            _location = glGetUniformLocation(p_program, _name);
+            _uploaded = false;
+        }
+
+        void set(const T& p_value) {
+            // -1: unknown or optimized away by the shader compiler
+            if (_location < 0 || (_uploaded && _value == p_value)) return;
+            _value = p_value;
+            _uploaded = true;
+            upload(_location, p_value);
+        }
+
+    private:
+        const char* _name;
+        GLint _location = -1;
+
+        T _value{};
+        bool _uploaded = false;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * Blocking FIFO between two pipeline stages. A full queue blocks the producer, so a fast stage can't run ahead of a
+ * slow one by more than the capacity (and the memory stays bounded).
+ */
+template <typename T>
+class BoundedQueue {
+    public:
+        explicit BoundedQueue(size_t p_capacity) : _capacity(p_capacity) {}
+
+        /**
+         * Append a value, blocks while the queue is full.
+         *
+         * @return false, if the queue has been closed (the value is dropped).
+         */
+        bool push(T p_value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notFull.wait(lock, [this] { return _closed || _values.size() < _capacity; });
+            if (_closed) return false;
+            _values.push_back(std::move(p_value));
+            _notEmpty.notify_one();
+            return true;
+        }
+
+        /**
+         * Take the oldest value, blocks while the queue is empty.
+         *
+         * @return false, once the queue is closed and empty.
+         */
+        bool pop(T& p_value) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notEmpty.wait(lock, [this] { return _closed || !_values.empty(); });
+            if (_values.empty()) return false;
+            p_value = std::move(_values.front());
+            _values.pop_front();
+            _notFull.notify_one();
+            return true;
+        }
+
+        /**
+         * No more values: wakes up all waiting stages, the remaining values can still be taken.
+         */
+        void close() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _closed = true;
+            _notEmpty.notify_all();
+            _notFull.notify_all();
+        }
+
+    private:
+        size_t _capacity;
+        std::deque<T> _values;
+        bool _closed = false;
+
+        std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+};
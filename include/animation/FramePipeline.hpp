@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Image.hpp>
+#include <animation/BoundedQueue.hpp>
+#include <cpu/TileScheduler.hpp>
+
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Encodes and writes the frames of an animation on threads of their own, while the caller renders the next frames.
+ *
+ * The stages are connected by bounded queues: rendering (compute and coloring, on the caller's thread, which owns the
+ * OpenGL context) -> encoding -> writing. A stage blocks once it's FRAME_QUEUE_SIZE frames ahead of the next one, so
+ * the slowest stage sets the pace and the memory stays bounded.
+ *
+ * Output:
+ * - "-": a YUV4MPEG2 stream (4:2:0) on stdout, e.g. for piping into ffmpeg.
+ * - *.y4m: the same stream into a file.
+ * - Otherwise a numbered image sequence (PNG or PPM, see createImageWriter). A single %d or %0Nd like in
+ *   frame_%05d.png sets the file names (%% is a literal %), without one the frame number is appended to the name
+ *   (zoom.png -> zoom_00000.png).
+ */
+class FramePipeline {
+    public:
+        /**
+         * Start the encoding and writing threads.
+         *
+         * @throws ImageWriteError, if the output can't be created, or its name has other conversions than the frame
+         *         number.
+         */
+        FramePipeline(const std::string& p_output, int p_width, int p_height, int p_framesPerSecond);
+
+        /**
+         * Stops the stages without waiting for pending frames, call finish to complete the output.
+         */
+        ~FramePipeline();
+
+        FramePipeline(const FramePipeline&) = delete;
+        FramePipeline& operator=(const FramePipeline&) = delete;
+
+        /**
+         * Hand over the next rendered frame, blocks while the encoding stage is too far behind.
+         *
+         * @throws The first error of the encoding or writing stage (e.g. ImageWriteError).
+         */
+        void push(Image p_frame);
+
+        /**
+         * Wait until all frames are written.
+         *
+         * @throws The first error of the encoding or writing stage.
+         */
+        void finish();
+
+    private:
+        static constexpr size_t FRAME_QUEUE_SIZE = 4;
+
+        void encodeLoop();
+        void writeLoop();
+
+        // Y'CbCr 4:2:0 (BT.601, limited range) behind a FRAME header
+        std::vector<uint8_t> encodeVideoFrame(const Image& p_frame);
+        // Split the output name of an image sequence around the frame number
+        void parseFramePattern();
+        std::string getFramePath(int p_index) const;
+
+        // Stop all stages and keep the first error
+        void fail(std::exception_ptr p_error);
+        void stop();
+
+        std::string _output;
+        bool _video;
+        int _width;
+        int _height;
+        int _writtenFrames = 0;
+        std::string _framePrefix;
+        std::string _frameSuffix;
+        int _frameDigits = 0;
+        std::ofstream _file;
+        std::ostream* _stream = nullptr;
+
+        // Compression of the image sequence, independent of the renderer's workers so both stages overlap
+        TileScheduler _scheduler;
+
+        BoundedQueue<Image> _frames{FRAME_QUEUE_SIZE};
+        BoundedQueue<std::vector<uint8_t>> _encodedFrames{FRAME_QUEUE_SIZE};
+
+        std::mutex _errorMutex;
+        std::exception_ptr _error;
+
+        std::thread _encoder;
+        std::thread _writer;
+};
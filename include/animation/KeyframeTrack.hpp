@@ -0,0 +1,56 @@
+#pragma once
+
+#include <precision/FixedPoint.hpp>
+#include <precision/FloatExp.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * A view of the animation at a given frame.
+ */
+struct Keyframe {
+        int frame;
+        FixedPoint real;
+        FixedPoint imaginary;
+        // Visible width
+        FloatExp scale;
+        int maxIterations;
+};
+
+/**
+ * Keyframes of a zoom animation and the views in between.
+ *
+ * The scale is interpolated exponentially, so the zoom speed is constant. The center follows the scale: its distance
+ * to the next keyframe's center shrinks in proportion to the difference of the scales, so a point zoomed into stays
+ * in place on the screen instead of drifting across it. The iteration limit is interpolated linearly.
+ */
+class KeyframeTrack {
+    public:
+        /**
+         * Read a keyframe file, one keyframe per line: <frame> <real> <imaginary> <scale> <iterations>.
+         * Frames must increase, '#' starts a comment. The center is read with full precision (see
+         * FixedPoint::fromString), the scale may be beyond the double range (e.g. 1e-400).
+         *
+         * @throws KeyframeError, if the file can't be read or is invalid.
+         */
+        explicit KeyframeTrack(const std::string& p_path);
+
+        /**
+         * @return Number of frames, up to and including the last keyframe.
+         */
+        int getFrameCount() const { return _keyframes.back().frame + 1; }
+
+        /**
+         * @return The interpolated view of a frame.
+         */
+        Keyframe at(int p_frame) const;
+
+        /**
+         * @return Whether all keyframes share one center, i.e. the animation only zooms.
+         */
+        bool hasFixedCenter() const;
+
+    private:
+        std::vector<Keyframe> _keyframes;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cpu/IterationBuffer.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Lossless container for IterationBuffers (frames, cache tiles, exports).
+ *
+ * Every count is predicted from its left, lower and lower-left neighbour with the median edge detector of LOCO-I /
+ * JPEG-LS, so iteration bands and the interior leave residuals close to 0. A residual is split into a token (the value
+ * itself below 16, its bit length otherwise) and raw extra bits. The tokens are entropy coded with a static rANS coder
+ * (12-bit probabilities, byte-wise renormalization), decoding costs a table lookup and a multiplication per pixel,
+ * which is orders of magnitude below recomputing it.
+ *
+ * Format (little endian): "GLFXITER", version (u32), width (u32), height (u32), token frequencies (u16 each),
+ * size of the rANS stream (u64), rANS stream, extra bits.
+ */
+class IterationCodec {
+    public:
+        /**
+         * @return The encoded buffer.
+         */
+        static std::vector<uint8_t> encode(const IterationBuffer& p_buffer);
+
+        /**
+         * Decode into p_buffer, which is resized to the encoded size.
+         *
+         * @throws IterationCodecError, if the data is truncated or not an encoded IterationBuffer.
+         */
+        static void decode(const uint8_t* p_data, size_t p_size, IterationBuffer& p_buffer);
+
+        static IterationBuffer decode(const std::vector<uint8_t>& p_data) {
+            IterationBuffer buffer;
+            decode(p_data.data(), p_data.size(), buffer);
+            return buffer;
+        }
+};
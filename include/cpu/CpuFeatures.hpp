@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * Widest vector instruction set usable for double precision escape-time loops.
+ */
+enum class SimdLevel {
+    // Plain C++ (non-x86 platforms)
+    Scalar,
+    // 2 doubles per vector
+    SSE2,
+    // 4 doubles per vector
+    AVX2,
+    // 8 doubles per vector
+    AVX512
+};
+
+/**
+ * Query cpuid (and the OS support for the extended register state) once.
+ *
+ * @return The widest instruction set supported by both the CPU and the operating system.
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * @return Human readable name of the instruction set.
+ */
+const char* getSimdLevelName(SimdLevel p_level);
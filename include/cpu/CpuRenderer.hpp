@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cpu/IEscapeTimeKernel.hpp>
+#include <cpu/TileScheduler.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Rectangles, which CpuRenderer fills without computing their inside (see CpuRenderer::setSubdivision).
+ */
+enum class Subdivision {
+    // Compute every pixel
+    Off,
+    // Fill rectangles bordered by interior pixels only. The Mandelbrot set is simply connected, a closed curve inside
+    // of it encloses nothing else. Only a sample in a cusp narrower than a pixel (e.g. at a bulb attachment) can be
+    // enclosed by interior samples and is lost.
+    Interior,
+    // Fill every rectangle with a uniform border, bands of the same iteration count as well. Filaments thinner than a
+    // pixel may slip between the border samples and are lost.
+    Uniform
+};
+
+/**
+ * Renders fractals on all CPU cores.
+ *
+ * The frame is split into tiles, which are distributed across a TileScheduler and computed by an IEscapeTimeKernel.
+ *
+ * With subdivision (Mariani-Silver), a tile only computes its border first. A uniform border is filled, otherwise the
+ * tile is split into quarters along its middle row and column, which are computed as the new borders. Tiles are
+ * still the parallel tasks, each one subdivides independently.
+ */
+class CpuRenderer {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param p_threadCount Number of worker threads, 0 uses one thread per hardware thread.
+         * @param p_tileSize Edge length of a tile in pixels.
+         */
+        explicit CpuRenderer(unsigned p_threadCount = 0, int p_tileSize = 64);
+
+        /**
+         * Render a whole frame.
+         *
+         * @param p_viewport The visible area of the fractal.
+         * @param p_kernel The kernel used to compute each tile.
+         * @param p_buffer Destination, its size defines the resolution of the frame.
+         */
+        void render(const Viewport& p_viewport, IEscapeTimeKernel& p_kernel, IterationBuffer& p_buffer);
+
+        /**
+         * Render parts of a frame, the remaining pixels of the buffer are left untouched.
+         *
+         * @param p_regions Rectangles of the buffer to compute, each one is split into tiles.
+         */
+        void render(const Viewport& p_viewport,
+                    IEscapeTimeKernel& p_kernel,
+                    IterationBuffer& p_buffer,
+                    const std::vector<Tile>& p_regions);
+
+        /**
+         * @return The scheduler running the tiles.
+         */
+        TileScheduler& getScheduler() { return _scheduler; }
+
+        /**
+         * Select which rectangles are filled instead of computed. Off by default.
+         */
+        void setSubdivision(Subdivision p_subdivision) { _subdivision = p_subdivision; }
+        Subdivision getSubdivision() const { return _subdivision; }
+
+        /**
+         * @return Pixels filled by the subdivision since the last reset.
+         */
+        uint64_t getFilledPixels() const { return _filledPixels; }
+
+        /**
+         * Reset the statistics (e.g. at the start of every frame).
+         */
+        void resetStatistics() { _filledPixels = 0; }
+
+        // Rectangles with a side below this (without their border) are computed instead of split
+        static constexpr int minSubdivisionSize = 10;
+
+    private:
+        // Fill or split a rectangle, whose border is already computed
+        void subdivide(const Viewport& p_viewport,
+                       IEscapeTimeKernel& p_kernel,
+                       IterationBuffer& p_buffer,
+                       const Tile& p_rectangle,
+                       uint64_t& p_filledPixels) const;
+
+        TileScheduler _scheduler;
+        int _tileSize;
+        Subdivision _subdivision = Subdivision::Off;
+        std::atomic<uint64_t> _filledPixels{0};
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cpu/IEscapeTimeKernel.hpp>
+#include <precision/DoubleDouble.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Escape-time loop in double-double arithmetic.
+ *
+ * The pixel offsets are small enough for plain doubles, only the center (Viewport::center + Viewport::centerLow) and
+ * the iterated values need the extra precision.
+ */
+class DoubleDoubleKernel : public IEscapeTimeKernel {
+    public:
+        void renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) override;
+
+        /**
+         * @return Pixels stopped by the periodicity detection since the last reset.
+         */
+        uint64_t getPeriodicPixels() const { return _periodicPixels; }
+
+        /**
+         * Reset the statistics (e.g. at the start of every frame).
+         */
+        void resetStatistics() { _periodicPixels = 0; }
+
+        /**
+         * Iterate z = z^2 + c until |z| > 2 or the maximum iteration count is reached, with the periodicity detection
+         * of MandelbrotKernel::iterate (differences to the saved z in double-double).
+         *
+         * @return The number of iterations before the orbit escaped.
+         */
+        static uint32_t iterate(const DoubleDouble& p_real,
+                                const DoubleDouble& p_imaginary,
+                                int p_maxIterations,
+                                double p_tolerance,
+                                uint64_t& p_periodicPixels);
+
+        /**
+         * MandelbrotKernel::isInMainCardioidOrBulb in double-double, plain doubles would misclassify pixels closer to
+         * the boundary than their rounding error.
+         */
+        static bool isInMainCardioidOrBulb(const DoubleDouble& p_real, const DoubleDouble& p_imaginary);
+
+    private:
+        std::atomic<uint64_t> _periodicPixels{0};
+};
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cpu/IterationBuffer.hpp>
+#include <cpu/Tile.hpp>
+#include <cpu/Viewport.hpp>
+
+/**
+ * Interface - Class.
+ * Computes the escape-time of a fractal for a single tile on the CPU.
+ *
+ * Implementations must be thread-safe, as tiles of the same frame are rendered concurrently.
+ */
+class IEscapeTimeKernel {
+    public:
+        /**
+         * Destructor
+         */
+        virtual ~IEscapeTimeKernel() {};
+
+        /**
+         * Write the iteration count of every pixel inside of the tile into the buffer.
+         *
+         * @param p_viewport The visible area of the fractal.
+         * @param p_tile The region of the buffer to compute.
+         * @param p_buffer Destination, its size defines the resolution of the frame.
+         */
+        virtual void renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cpu/Tile.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/**
+ * Escape-time result of every pixel of a frame.
+ *
+ * Rows are stored bottom-up, so that row 0 matches gl_FragCoord.y == 0.5 and the buffer can be uploaded as a texture
+ * without flipping.
+ */
+class IterationBuffer {
+    public:
+        IterationBuffer() = default;
+        IterationBuffer(int p_width, int p_height) { resize(p_width, p_height); }
+
+        /**
+         * Resize the buffer. The content is undefined afterwards.
+         *
+         * @param p_width Width in pixels.
+         * @param p_height Height in pixels.
+         */
+        void resize(int p_width, int p_height) {
+            _width = p_width;
+            _height = p_height;
+            _data.resize(static_cast<size_t>(p_width) * p_height);
+        }
+
+        /**
+         * Move the content by whole pixels: at(x + p_dx, y + p_dy) receives the old at(x, y). The exposed pixels are
+         * undefined afterwards.
+         */
+        void shift(int p_dx, int p_dy) {
+            const int rowLength = _width - std::abs(p_dx);
+            if (rowLength <= 0 || std::abs(p_dy) >= _height) return;
+
+            // Rows are processed away from the destination, so no source row is overwritten before it's moved
+            const int sourceX = std::max(0, -p_dx);
+            const int targetX = std::max(0, p_dx);
+            for (int i = 0; i < _height - std::abs(p_dy); i++) {
+                const int targetY = p_dy > 0 ? _height - 1 - i : i;
+                std::memmove(&at(targetX, targetY), &at(sourceX, targetY - p_dy), rowLength * sizeof(uint32_t));
+            }
+        }
+
+        /**
+         * Zoom the content out by an odd factor around the center. Pixel centers are at x + 0.5, so with an odd
+         * factor the new pixel x samples exactly the old pixel factor * x + (factor - 1) * (1 - width) / 2 and keeps
+         * its value. The pixels outside of the returned region are undefined afterwards.
+         *
+         * @return The region holding the kept values.
+         */
+        Tile shrink(int p_factor) {
+            const int offsetX = (p_factor - 1) / 2 * (1 - _width);
+            const int offsetY = (p_factor - 1) / 2 * (1 - _height);
+            const int x0 = (-offsetX + p_factor - 1) / p_factor;
+            const int y0 = (-offsetY + p_factor - 1) / p_factor;
+            const int x1 = (_width - 1 - offsetX) / p_factor + 1;
+            const int y1 = (_height - 1 - offsetY) / p_factor + 1;
+
+            const std::vector<uint32_t> previous = _data;
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) {
+                    at(x, y) = previous[static_cast<size_t>(p_factor * y + offsetY) * _width + p_factor * x + offsetX];
+                }
+            }
+            return {x0, y0, x1 - x0, y1 - y0};
+        }
+
+        int getWidth() const { return _width; }
+        int getHeight() const { return _height; }
+
+        uint32_t& at(int p_x, int p_y) { return _data[static_cast<size_t>(p_y) * _width + p_x]; }
+        uint32_t at(int p_x, int p_y) const { return _data[static_cast<size_t>(p_y) * _width + p_x]; }
+
+        uint32_t* getData() { return _data.data(); }
+        const uint32_t* getData() const { return _data.data(); }
+
+    private:
+        int _width = 0;
+        int _height = 0;
+        std::vector<uint32_t> _data;
+};
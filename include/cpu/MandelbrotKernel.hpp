@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cpu/IEscapeTimeKernel.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * CPU implementation of the escape-time loop in Mandelbrot::getFragmentShaderSource.
+ */
+class MandelbrotKernel : public IEscapeTimeKernel {
+    public:
+        void renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) override;
+
+        /**
+         * @return Pixels stopped by the periodicity detection since the last reset.
+         */
+        uint64_t getPeriodicPixels() const { return _periodicPixels; }
+
+        /**
+         * Reset the statistics (e.g. at the start of every frame).
+         */
+        void resetStatistics() { _periodicPixels = 0; }
+
+        /**
+         * Iterate z = z^2 + c until |z| > 2 or the maximum iteration count is reached.
+         *
+         * Orbits of interior points converge to an attracting cycle. Brent's algorithm finds it: z is saved after
+         * 64, 192, 448, ... iterations (windows of doubling length) and every z of the window is compared to it, so a
+         * cycle is detected soon after the orbit has settled and the window has grown beyond its period. The pixel
+         * then counts as interior (p_maxIterations). Most exterior pixels escape before the first window, they
+         * don't pay for saving z.
+         *
+         * @param p_tolerance Distance at which two points count as equal (see getPeriodicityTolerance), 0 disables
+         * the detection.
+         * @param p_periodicPixels Incremented, if the orbit was stopped by the periodicity detection.
+         *
+         * @return The number of iterations before the orbit escaped.
+         */
+        static uint32_t iterate(double p_real,
+                                double p_imaginary,
+                                int p_maxIterations,
+                                double p_tolerance,
+                                uint64_t& p_periodicPixels);
+
+        /**
+         * Analytic test for the two largest components of the interior, whose points never escape and would otherwise
+         * run to the maximum iteration count: the main cardioid (q * (q + x - 1/4) < y^2 / 4 with
+         * q = (x - 1/4)^2 + y^2) and the period-2 bulb ((x + 1)^2 + y^2 < 1/16).
+         */
+        static bool isInMainCardioidOrBulb(double p_real, double p_imaginary) {
+            const double real = p_real - 0.25;
+            const double imaginary2 = p_imaginary * p_imaginary;
+            const double q = real * real + imaginary2;
+            if (q * (q + real) < 0.25 * imaginary2) return true;
+            return (p_real + 1.0) * (p_real + 1.0) + imaginary2 < 0.0625;
+        }
+
+        // Iteration of the first saved z and length of the first window (see iterate)
+        static constexpr int firstPeriodicityCheckpoint = 64;
+
+    private:
+        std::atomic<uint64_t> _periodicPixels{0};
+};
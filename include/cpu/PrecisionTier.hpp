@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+
+/**
+ * Number representation used to iterate the pixels, chosen from the zoom depth.
+ */
+enum class PrecisionTier {
+    // Plain double precision, c is computed directly
+    Double,
+    // Double-double arithmetic (~106 bits), c is computed directly (DoubleDoubleKernel)
+    DoubleDouble,
+    // Double precision differences to a high precision reference orbit (PerturbationKernel)
+    Perturbation
+};
+
+/**
+ * Pick the cheapest tier, which still resolves neighbouring pixels.
+ *
+ * @param p_pixelSize Distance between two neighbouring pixels in the complex plane.
+ */
+inline PrecisionTier selectPrecisionTier(double p_pixelSize) {
+    // Below ~1e-13 (~1e-29 for double-double) consecutive numbers around |c| ~ 1 are further apart than the pixels
+    if (p_pixelSize >= 1e-12) return PrecisionTier::Double;
+    if (p_pixelSize >= 1e-28) return PrecisionTier::DoubleDouble;
+    return PrecisionTier::Perturbation;
+}
+
+/**
+ * Distance below which two points of an orbit count as equal for the periodicity detection (see
+ * MandelbrotKernel::iterate): a thousandth of a pixel, but not below the rounding noise of the tier's arithmetic
+ * (~2^-45 for |z| <= 2 in double, ~2^-95 in double-double), where orbits would never compare equal.
+ *
+ * @param p_pixelSize Distance between two neighbouring pixels in the complex plane.
+ */
+inline double getPeriodicityTolerance(PrecisionTier p_tier, double p_pixelSize) {
+    const double noise = p_tier == PrecisionTier::Double ? 0x1p-45 : 0x1p-95;
+    return std::max(p_pixelSize * 0x1p-10, noise);
+}
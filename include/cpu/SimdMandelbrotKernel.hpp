@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cpu/CpuFeatures.hpp>
+#include <cpu/IEscapeTimeKernel.hpp>
+#include <cpu/MandelbrotKernel.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Plain description of a tile for the vectorized loops.
+ *
+ * The vectorized translation units are compiled with different instruction set flags and must not call any inline
+ * function shared with the rest of the program, so everything they need is precomputed here.
+ */
+struct SimdTileJob {
+        double centerReal;
+        double centerImaginary;
+        double pixelSize;
+        // Half of the frame size, c = center + (pixel + 0.5 - half) * pixelSize
+        double halfWidth;
+        double halfHeight;
+
+        int x;
+        int y;
+        int width;
+        int height;
+        int maxIterations;
+        // See Viewport::interiorCheck
+        bool interiorCheck;
+        // See MandelbrotKernel::iterate, 0 disables the periodicity detection
+        double periodicityTolerance;
+
+        // Pixel (0, 0) of the frame and the number of pixels per row
+        uint32_t* output;
+        int stride;
+
+        // Incremented by the number of pixels stopped by the periodicity detection
+        uint64_t* periodicPixels;
+};
+
+/**
+ * Vectorized version of MandelbrotKernel (SSE2, AVX2 or AVX-512, selected at runtime).
+ *
+ * Each vector lane iterates its own pixel. As soon as a lane escapes, its result is written and the lane is refilled
+ * with the next pixel of the tile (lane compaction), so lanes never idle until the slowest pixel of a group finishes.
+ * The results are bit-identical to MandelbrotKernel.
+ */
+class SimdMandelbrotKernel : public IEscapeTimeKernel {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param p_level Instruction set to use. Falls back to the best supported one, if the CPU lacks it.
+         */
+        explicit SimdMandelbrotKernel(SimdLevel p_level = detectSimdLevel());
+
+        void renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) override;
+
+        /**
+         * @return The instruction set in use.
+         */
+        SimdLevel getLevel() const { return _level; }
+
+        /**
+         * @return Pixels stopped by the periodicity detection since the last reset (see MandelbrotKernel::iterate).
+         */
+        uint64_t getPeriodicPixels() const { return _periodicPixels + _fallback.getPeriodicPixels(); }
+
+        /**
+         * Reset the statistics (e.g. at the start of every frame).
+         */
+        void resetStatistics() {
+            _periodicPixels = 0;
+            _fallback.resetStatistics();
+        }
+
+    private:
+        static void renderTileSse2(const SimdTileJob& p_job);
+        static void renderTileAvx2(const SimdTileJob& p_job);
+        static void renderTileAvx512(const SimdTileJob& p_job);
+
+        SimdLevel _level;
+        // Used without SIMD support
+        MandelbrotKernel _fallback;
+        std::atomic<uint64_t> _periodicPixels{0};
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+/**
+ * Rectangular region of an IterationBuffer, which is rendered as one unit of work.
+ */
+struct Tile {
+        int x;
+        int y;
+        int width;
+        int height;
+};
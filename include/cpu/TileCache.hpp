@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cpu/CpuRenderer.hpp>
+#include <cpu/TileKey.hpp>
+#include <cpu/TileStore.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Iteration counts of previously rendered areas, organized as a quadtree pyramid like a web map: level L divides the
+ * complex plane into tiles of 2^(2 - L) x 2^(2 - L) with TILE_SIZE x TILE_SIZE samples each.
+ *
+ * A frame is assembled from the coarsest level, whose samples are not coarser than the pixels of the frame (nearest
+ * sample). Missing tiles are computed with the CpuRenderer, the least recently used tiles are evicted as soon as the
+ * memory budget is exceeded. Revisiting an area (or going back to a previous zoom level) doesn't compute anything.
+ * With a TileStore (openStore), computed tiles are also written to disk and read back from there once evicted, or
+ * after a restart.
+ *
+ * The sample indices are 64-bit integers, which limits the cache to pixel sizes above ~1e-18 (MAX_LEVEL), deeper
+ * frames have to bypass it.
+ */
+class TileCache {
+    public:
+        static constexpr int TILE_SIZE = 256;
+        static constexpr int MAX_LEVEL = 54;
+
+        /**
+         * Picks the kernel for a tile, e.g. by the precision its pixel size requires.
+         */
+        using KernelSelector = std::function<IEscapeTimeKernel&(const Viewport&)>;
+
+        /**
+         * @param p_memoryBudget Maximum size of all cached tiles in bytes.
+         */
+        explicit TileCache(size_t p_memoryBudget = size_t(256) << 20) : _memoryBudget(p_memoryBudget) {}
+
+        /**
+         * Change the budget, evicts tiles if necessary.
+         */
+        void setMemoryBudget(size_t p_memoryBudget);
+
+        /**
+         * Persist tiles in p_directory (see TileStore), tiles stored by earlier sessions are used right away.
+         *
+         * @throws TileStoreError, if the store can't be opened.
+         */
+        void openStore(const std::string& p_directory) {
+            _store = std::make_unique<TileStore>(p_directory, TILE_SIZE * TILE_SIZE);
+        }
+
+        /**
+         * @return The attached store, nullptr if there is none.
+         */
+        const TileStore* getStore() const { return _store.get(); }
+
+        size_t getMemoryUsage() const { return _entries.size() * TILE_SIZE * TILE_SIZE * sizeof(uint32_t); }
+
+        /**
+         * @return The pyramid level used for frames with the given pixel size, -1 if they are too deep for the cache.
+         */
+        static int levelFor(double p_pixelSize);
+
+        /**
+         * Fill the regions of the buffer from cached tiles only.
+         *
+         * @return false (leaving the buffer untouched), if a tile is missing.
+         */
+        bool lookup(const Viewport& p_viewport, IterationBuffer& p_buffer, const std::vector<Tile>& p_regions);
+
+        /**
+         * Fill the regions of the buffer, missing tiles are computed and added to the cache.
+         *
+         * @param p_renderer Computes the missing tiles.
+         * @param p_selectKernel Kernel for each missing tile.
+         */
+        void render(const Viewport& p_viewport,
+                    CpuRenderer& p_renderer,
+                    const KernelSelector& p_selectKernel,
+                    IterationBuffer& p_buffer,
+                    const std::vector<Tile>& p_regions);
+
+        /**
+         * Counters of the tiles found in memory / found in the store / computed (accumulated until resetStatistics).
+         */
+        uint64_t getHits() const { return _hits; }
+        uint64_t getStoreHits() const { return _storeHits; }
+        uint64_t getMisses() const { return _misses; }
+
+        void resetStatistics() {
+            _hits = 0;
+            _storeHits = 0;
+            _misses = 0;
+        }
+
+        /**
+         * Drop the tiles in memory, the store is kept.
+         */
+        void clear();
+
+    private:
+        struct Entry {
+                TileKey key;
+                IterationBuffer samples;
+        };
+
+        // Look up (or compute, if p_renderer is set) the tiles and copy the samples into the regions
+        bool assemble(const Viewport& p_viewport,
+                      CpuRenderer* p_renderer,
+                      const KernelSelector* p_selectKernel,
+                      IterationBuffer& p_buffer,
+                      const std::vector<Tile>& p_regions);
+
+        // Evict the least recently used tiles until the budget is met
+        void evict();
+
+        size_t _memoryBudget;
+        std::unique_ptr<TileStore> _store;
+
+        // Most recently used first
+        std::list<Entry> _entries;
+        std::unordered_map<TileKey, std::list<Entry>::iterator, TileKeyHash> _index;
+
+        uint64_t _hits = 0;
+        uint64_t _storeHits = 0;
+        uint64_t _misses = 0;
+};
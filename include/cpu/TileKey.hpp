@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Address of a tile in the pyramid: tile (x, y) of level L covers [x, x + 1) * 2^(2 - L) x [y, y + 1) * 2^(2 - L).
+ */
+struct TileKey {
+        int level;
+        int64_t x;
+        int64_t y;
+        // Iteration limit the tile was computed with
+        int maxIterations;
+
+        bool operator==(const TileKey& p_other) const {
+            return level == p_other.level && x == p_other.x && y == p_other.y &&
+                   maxIterations == p_other.maxIterations;
+        }
+};
+
+/**
+ * Hash of a TileKey for unordered containers.
+ */
+struct TileKeyHash {
+        size_t operator()(const TileKey& p_key) const {
+            uint64_t hash = static_cast<uint64_t>(p_key.x) * 0x9E3779B97F4A7C15ull;
+            hash ^= static_cast<uint64_t>(p_key.y) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+            hash ^= (static_cast<uint64_t>(p_key.level) << 32) ^ static_cast<uint64_t>(p_key.maxIterations);
+            return static_cast<size_t>(hash);
+        }
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cpu/Tile.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Persistent pool of worker threads, which process tiles with work stealing.
+ *
+ * Every worker owns a queue of tiles. Once its own queue is empty, it steals tiles from the other workers, so that
+ * expensive regions (e.g. the interior of the Mandelbrot set) don't leave the remaining cores idle.
+ */
+class TileScheduler {
+    public:
+        using Task = std::function<void(const Tile&, unsigned)>;
+
+        /**
+         * Constructor.
+         *
+         * @param p_threadCount Number of worker threads, 0 uses one thread per hardware thread.
+         */
+        explicit TileScheduler(unsigned p_threadCount = 0);
+
+        /**
+         * Destructor.
+         *
+         * Stops and joins all worker threads.
+         */
+        ~TileScheduler();
+
+        TileScheduler(const TileScheduler&) = delete;
+        TileScheduler& operator=(const TileScheduler&) = delete;
+
+        /**
+         * Process all tiles and block until every tile is done.
+         *
+         * @param p_tiles The tiles to process.
+         * @param p_task Executed once per tile, receives the tile and the index of the executing worker.
+         *
+         * @throws The first exception thrown by p_task.
+         */
+        void run(const std::vector<Tile>& p_tiles, const Task& p_task);
+
+        /**
+         * @return The number of worker threads.
+         */
+        unsigned getThreadCount() const { return static_cast<unsigned>(_threads.size()); }
+
+        /**
+         * Split a frame into tiles of (at most) p_tileSize x p_tileSize pixels, row by row.
+         */
+        static std::vector<Tile> splitIntoTiles(int p_width, int p_height, int p_tileSize);
+
+    private:
+        struct WorkerQueue {
+                std::mutex mutex;
+                std::deque<Tile> tiles;
+        };
+
+        void workerLoop(unsigned p_index);
+        bool popTile(unsigned p_index, Tile& p_tile);
+
+        std::vector<std::thread> _threads;
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+        // Serializes concurrent calls of run()
+        std::mutex _runMutex;
+
+        std::mutex _mutex;
+        std::condition_variable _wakeCondition;
+        std::condition_variable _doneCondition;
+        uint64_t _generation = 0;
+        unsigned _activeWorkers = 0;
+        bool _stopping = false;
+
+        const Task* _task = nullptr;
+
+        std::mutex _errorMutex;
+        std::exception_ptr _error;
+};
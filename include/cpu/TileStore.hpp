@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cpu/TileKey.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Tiles of the TileCache persisted in a directory, so they survive restarts:
+ *
+ * - tiles.dat: the samples of every stored tile, one after another (never rewritten). The file is extended ahead of
+ *   the tiles in chunks, which double in size, unused space at the end is zero.
+ * - tiles.idx: header (magic, version, samples per tile), then one (key, tile number) record per tile
+ *
+ * Only the small index is read on startup. The data file is memory mapped and find returns pointers into the mapping,
+ * so reading a tile neither copies it nor allocates, the OS pages it in on first access. Chunks added later are
+ * mapped on demand in additional segments, earlier pointers stay valid until the store is destroyed. As the chunks
+ * grow geometrically, a long session needs only a logarithmic number of mappings.
+ *
+ * The data is always flushed before the index record, a crash leaves at most a partial record behind, which is
+ * dropped on the next open. Only one process may use a directory at a time.
+ */
+class TileStore {
+    public:
+        /**
+         * Open the store in p_directory, creates the directory and the files if necessary.
+         *
+         * @param p_samplesPerTile Samples of each tile (must match the existing files).
+         *
+         * @throws TileStoreError, if the files can't be opened or belong to a different tile size.
+         */
+        TileStore(const std::string& p_directory, int p_samplesPerTile);
+
+        /**
+         * Unmaps the data file, all pointers returned by find become invalid.
+         */
+        ~TileStore();
+
+        TileStore(const TileStore&) = delete;
+        TileStore& operator=(const TileStore&) = delete;
+
+        /**
+         * @return The samples of the tile (rows bottom-up, like IterationBuffer), nullptr if it isn't stored.
+         */
+        const uint32_t* find(const TileKey& p_key);
+
+        /**
+         * Append a tile to the files. Tiles, which are already stored, are ignored.
+         *
+         * @throws TileStoreError, if writing fails.
+         */
+        void append(const TileKey& p_key, const uint32_t* p_samples);
+
+        size_t getTileCount() const { return _index.size(); }
+
+    private:
+        // A mapped range of the data file
+        struct Segment {
+                const uint32_t* samples;
+                uint64_t firstTile;
+                uint64_t tileCount;
+        };
+
+        // Tiles, by which the data file is extended at least
+        static constexpr uint64_t MIN_RESERVED_TILES = 64;
+
+        // Map the chunks reserved since the last call
+        void mapTail();
+        // Extend the data file, so that at least one more tile fits
+        void reserve();
+
+        size_t _tileBytes;
+        std::string _dataPath;
+        std::FILE* _dataFile = nullptr;
+        std::FILE* _indexFile = nullptr;
+
+        // Tiles written / fitting into the data file / covered by the segments
+        uint64_t _storedTiles = 0;
+        uint64_t _reservedTiles = 0;
+        uint64_t _mappedTiles = 0;
+        std::vector<Segment> _segments;
+
+        // Tile number in the data file
+        std::unordered_map<TileKey, uint64_t, TileKeyHash> _index;
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <precision/FloatExp.hpp>
+
+#include <utility>
+
+/**
+ * The part of the complex plane, which is currently being rendered.
+ *
+ * Shared by the GPU and the CPU path, so both produce the same pixels for the same state.
+ */
+struct Viewport {
+        // Complex number in the middle of the frame
+        std::pair<double, double> center;
+
+        // Width of the visible area in the complex plane (extended exponent, deep zooms leave the double range)
+        FloatExp scale;
+
+        int maxIterations;
+
+        // Low-order parts of the center, center + centerLow is a double-double (see DoubleDoubleKernel)
+        std::pair<double, double> centerLow = {0.0, 0.0};
+
+        // Skip the main cardioid and the period-2 bulb analytically (see MandelbrotKernel::isInMainCardioidOrBulb)
+        bool interiorCheck = true;
+
+        // Stop orbits, which have fallen into an attracting cycle (see MandelbrotKernel::iterate)
+        bool periodicityCheck = true;
+
+        /**
+         * Distance between two neighbouring pixels in the complex plane.
+         *
+         * @param p_width Width of the frame in pixels.
+         */
+        double getPixelSize(int p_width) const { return scale.toDouble() / p_width; }
+
+        /**
+         * Same as getPixelSize, without underflow below ~1e-308.
+         */
+        FloatExp getExtendedPixelSize(int p_width) const { return scale / FloatExp(p_width); }
+
+        /**
+         * Real part of the center of a pixel (equivalent to gl_FragCoord.x in the shader).
+         */
+        double pixelToReal(int p_x, int p_width) const {
+            return center.first + (p_x + 0.5 - p_width / 2.0) * getPixelSize(p_width);
+        }
+
+        /**
+         * Imaginary part of the center of a pixel (equivalent to gl_FragCoord.y in the shader).
+         */
+        double pixelToImaginary(int p_y, int p_width, int p_height) const {
+            return center.second + (p_y + 0.5 - p_height / 2.0) * getPixelSize(p_width);
+        }
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * Throw, when an exported image can't be written.
+ */
+class ImageWriteError : public std::runtime_error {
+    public:
+        ImageWriteError(const std::string& p_path, const std::string& p_reason)
+            : std::runtime_error("Unable to write " + p_path + ": " + p_reason) {}
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * Throw, when encoded iteration data can't be decoded.
+ */
+class IterationCodecError : public std::runtime_error {
+    public:
+        explicit IterationCodecError(const std::string& p_reason)
+            : std::runtime_error("Invalid iteration data: " + p_reason) {}
+};
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * Throw, when a keyframe file can't be read or contains invalid keyframes.
+ */
+class KeyframeError : public std::runtime_error {
+    public:
+        KeyframeError(const std::string& p_path, const std::string& p_reason)
+            : std::runtime_error("Keyframes " + p_path + ": " + p_reason) {}
+};
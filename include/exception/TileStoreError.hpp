@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * Throw, when the files of a TileStore can't be opened, read or written.
+ */
+class TileStoreError : public std::runtime_error {
+    public:
+        TileStoreError(const std::string& p_path, const std::string& p_reason)
+            : std::runtime_error("Tile store " + p_path + ": " + p_reason) {}
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * DEFLATE (RFC 1951) compressor and the checksums of zlib / PNG, for the image writers.
+ *
+ * Made for parallel compression like pigz: a stream is cut into pieces, which are compressed independently on worker
+ * threads. Each piece ends byte aligned with an empty stored block, so the pieces can simply be concatenated. A piece
+ * may still refer back into the data before it (up to 32 KiB), which keeps the ratio close to a serial compression.
+ *
+ * Greedy LZ77 matching (one hash candidate), then a dynamic Huffman block per 64K symbols.
+ */
+class Deflate {
+    public:
+        /**
+         * Append the compressed p_data[0, p_size) to p_out as non-final blocks.
+         *
+         * @param p_dictionary Bytes directly before p_data, which precede it in the stream and may be referenced.
+         */
+        static void compress(const uint8_t* p_data, size_t p_size, size_t p_dictionary, std::vector<uint8_t>& p_out);
+
+        /**
+         * Append the end of the stream (an empty final block).
+         */
+        static void finish(std::vector<uint8_t>& p_out);
+
+        /**
+         * @param p_adler Checksum of the preceding data, 1 at the start.
+         */
+        static uint32_t adler32(uint32_t p_adler, const uint8_t* p_data, size_t p_size);
+
+        /**
+         * @return The checksum of two concatenated pieces, computed from the checksums of each piece.
+         */
+        static uint32_t combineAdler32(uint32_t p_first, uint32_t p_second, size_t p_secondSize);
+
+        /**
+         * @param p_crc Checksum of the preceding data, 0 at the start.
+         */
+        static uint32_t crc32(uint32_t p_crc, const uint8_t* p_data, size_t p_size);
+};
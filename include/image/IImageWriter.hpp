@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Image.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class TileScheduler;
+
+/**
+ * Streaming image file: the rows are handed over in bands, top-down, so a large image never has to be in memory as a
+ * whole.
+ */
+class IImageWriter {
+    public:
+        virtual ~IImageWriter() {}
+
+        /**
+         * Write the next band.
+         *
+         * @param p_pixels RGB, 8 bits per channel, p_rows rows of the image width, top-down.
+         *
+         * @throws ImageWriteError, if writing fails.
+         */
+        virtual void writeRows(const uint8_t* p_pixels, int p_rows) = 0;
+
+        /**
+         * Complete the file, after all rows are written.
+         *
+         * @throws ImageWriteError, if rows are missing or writing fails.
+         */
+        virtual void finish() = 0;
+};
+
+/**
+ * @return Whether p_path has the extension .png (case insensitive).
+ */
+bool isPngPath(const std::string& p_path);
+
+/**
+ * Create a writer for the format of the file extension: PNG for .png, otherwise binary PPM.
+ *
+ * @param p_scheduler Worker threads for the compression of PNGs.
+ *
+ * @throws ImageWriteError, if the file can't be created.
+ */
+std::unique_ptr<IImageWriter> createImageWriter(const std::string& p_path, int p_width, int p_height,
+                                                TileScheduler& p_scheduler);
+
+/**
+ * Write a whole image (see createImageWriter).
+ */
+void saveImage(const std::string& p_path, const Image& p_image, TileScheduler& p_scheduler);
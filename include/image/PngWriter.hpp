@@ -0,0 +1,52 @@
+#pragma once
+
+#include <image/IImageWriter.hpp>
+
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class TileScheduler;
+
+/**
+ * PNG (8 bit RGB), compressed in parallel.
+ *
+ * Every band is filtered row by row (the filter with the smallest sum of absolute differences) and cut into pieces of
+ * about 128 KiB, which the workers of a TileScheduler compress independently (see Deflate). Each piece becomes an
+ * IDAT chunk of its own, the Adler-32 of the zlib stream is combined from the checksums of the pieces.
+ */
+class PngWriter : public IImageWriter {
+    public:
+        /**
+         * @throws ImageWriteError, if the file can't be created.
+         */
+        PngWriter(const std::string& p_path, int p_width, int p_height, TileScheduler& p_scheduler);
+
+        /**
+         * Write into a stream instead (e.g. to encode in memory), it must outlive the writer.
+         */
+        PngWriter(std::ostream& p_stream, int p_width, int p_height, TileScheduler& p_scheduler);
+
+        void writeRows(const uint8_t* p_pixels, int p_rows) override;
+        void finish() override;
+
+    private:
+        void writeHeader();
+        void writeChunk(const char* p_type, const uint8_t* p_data, size_t p_size, uint32_t p_crc);
+        void writeChunk(const char* p_type, const std::vector<uint8_t>& p_data);
+
+        std::string _path;
+        int _width;
+        int _height;
+        TileScheduler& _scheduler;
+        int _writtenRows = 0;
+        std::ofstream _file;
+        std::ostream& _stream;
+
+        // Last row of the previous band, the filters refer to it
+        std::vector<uint8_t> _previousRow;
+        // Filtered bytes at the end of the previous band, the compression of the next band may refer to them
+        std::vector<uint8_t> _history;
+        uint32_t _adler = 1;
+};
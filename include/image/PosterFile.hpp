@@ -0,0 +1,59 @@
+#pragma once
+
+#include <image/IImageWriter.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+/**
+ * Binary PPM (P6) of a poster, which is too large for a single frame. The fractal renders it in bands of rows and
+ * hands them over one after another, only one band has to be in memory.
+ *
+ * The file is created at its final size up front (sparse, where the file system supports it), so every band has a
+ * fixed place. After each band <path>.progress records the number of finished rows. Opening the same job again
+ * (e.g. after a crash) continues behind the last finished band, a different job starts over.
+ */
+class PosterFile : public IImageWriter {
+    public:
+        /**
+         * Create the file, or resume it.
+         *
+         * @param p_job Describes the export (view, size, ...), resuming requires the same description.
+         *
+         * @throws ImageWriteError, if the file can't be created.
+         */
+        PosterFile(const std::string& p_path, int p_width, int p_height, const std::string& p_job);
+
+        /**
+         * @return Rows (from the top), which are already in the file.
+         */
+        int getCompletedRows() const { return _completedRows; }
+
+        /**
+         * Write the next band and record the progress.
+         *
+         * @param p_pixels RGB, 8 bits per channel, p_rows rows of the poster width, top-down.
+         *
+         * @throws ImageWriteError, if writing fails.
+         */
+        void writeRows(const uint8_t* p_pixels, int p_rows) override;
+
+        /**
+         * Remove the progress record once all rows are written.
+         */
+        void finish() override;
+
+    private:
+        // Replace the progress record (atomically, via rename)
+        void saveProgress() const;
+
+        std::string _path;
+        std::string _progressPath;
+        std::string _job;
+        int _width;
+        int _height;
+        int _completedRows = 0;
+        std::streamoff _headerSize = 0;
+        std::fstream _file;
+};
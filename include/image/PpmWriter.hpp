@@ -0,0 +1,34 @@
+#pragma once
+
+#include <image/IImageWriter.hpp>
+
+#include <fstream>
+#include <ostream>
+#include <string>
+
+/**
+ * Binary PPM (P6): the rows are written as they are, which makes it the fastest format to save.
+ */
+class PpmWriter : public IImageWriter {
+    public:
+        /**
+         * @throws ImageWriteError, if the file can't be created.
+         */
+        PpmWriter(const std::string& p_path, int p_width, int p_height);
+
+        /**
+         * Write into a stream instead (e.g. to encode in memory), it must outlive the writer.
+         */
+        PpmWriter(std::ostream& p_stream, int p_width, int p_height);
+
+        void writeRows(const uint8_t* p_pixels, int p_rows) override;
+        void finish() override;
+
+    private:
+        std::string _path;
+        int _width;
+        int _height;
+        int _writtenRows = 0;
+        std::ofstream _file;
+        std::ostream& _stream;
+};
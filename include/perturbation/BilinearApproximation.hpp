@@ -0,0 +1,83 @@
+#pragma once
+
+#include <perturbation/ReferenceOrbit.hpp>
+
+#include <vector>
+
+/**
+ * Linear skip over several iterations of the perturbation loop: d_(m+length) = A * d_m + B * dc.
+ * Valid as long as |d_m| < radius.
+ */
+struct BlaStep {
+        double aReal;
+        double aImaginary;
+        double bReal;
+        double bImaginary;
+        double radius;
+        int length;
+};
+
+/**
+ * Bilinear approximation (BLA) table of a reference orbit.
+ *
+ * Level 0 holds one step per iteration m >= 1 (A = 2 * Z_m, B = 1). Level k + 1 merges two neighbouring steps of
+ * level k, so an entry of level k starts at iteration 1 + index * 2^k and skips up to 2^k iterations at once.
+ * Per pixel, the largest valid step starting at the current iteration is applied.
+ */
+class BilinearApproximation {
+    public:
+        /**
+         * Build the table.
+         *
+         * @param p_orbit The reference orbit.
+         * @param p_maxDeltaC Largest |dc| of all pixels using the table, the radii are conservative for smaller ones.
+         */
+        void compute(const ReferenceOrbit& p_orbit, double p_maxDeltaC);
+
+        /**
+         * Find the largest step starting at the given iteration.
+         *
+         * @param p_iteration Current iteration of the pixel.
+         * @param p_deltaNorm2 Squared magnitude |d|^2 of the pixel.
+         * @param p_maxLength The step must not advance beyond this many iterations.
+         *
+         * @return The step or nullptr, if no step is valid.
+         */
+        const BlaStep* lookup(int p_iteration, double p_deltaNorm2, int p_maxLength) const {
+            if (p_iteration < 1) return nullptr;
+
+            // A merged step is never valid for a larger radius than its first half, so climb until a step fails
+            const int position = p_iteration - 1;
+            const BlaStep* best = nullptr;
+            for (size_t level = 0; level < _levels.size(); level++) {
+                if (position & ((1 << level) - 1)) break;
+
+                const size_t index = static_cast<size_t>(position >> level);
+                if (index >= _levels[level].size()) break;
+
+                const BlaStep& step = _levels[level][index];
+                if (step.length > p_maxLength || p_deltaNorm2 >= step.radius * step.radius) break;
+                best = &step;
+            }
+            return best;
+        }
+
+        /**
+         * @return |dc| the table has been built for.
+         */
+        double getMaxDeltaC() const { return _maxDeltaC; }
+
+        int getLevelCount() const { return static_cast<int>(_levels.size()); }
+        const std::vector<BlaStep>& getLevel(int p_level) const { return _levels[p_level]; }
+
+        /**
+         * Serialize all levels for the GPU: 6 doubles (A, B, radius, length) per step, level after level.
+         *
+         * @param p_levelOffsets Receives the index of the first step of every level.
+         */
+        std::vector<double> serialize(std::vector<int>& p_levelOffsets) const;
+
+    private:
+        std::vector<std::vector<BlaStep>> _levels;
+        double _maxDeltaC = 0.0;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cpu/IterationBuffer.hpp>
+#include <cpu/TileScheduler.hpp>
+#include <perturbation/BilinearApproximation.hpp>
+#include <perturbation/ReferenceOrbit.hpp>
+#include <precision/FixedPoint.hpp>
+#include <precision/FloatExp.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * Iteration counts around a fixed zoom center on a log-polar grid (exponential map), from which every frame of a zoom
+ * into that center is resampled instead of rendered.
+ *
+ * Ring i holds the samples at the radius anchor * e^(-i * step) at the angles 2 pi j / angles, with step = 2 pi /
+ * angles, so the cells are square and every ring is as fine as a frame's pixels at its outer corner. Frames of a
+ * zoom only differ in which rings they use: the total work is proportional to the zoom depth (~4 frames per e-fold of
+ * magnification, ~30 for the first frame), not to the number of frames.
+ *
+ * Rings are computed on demand and the ones outside of the last frame are dropped while zooming in, so the memory
+ * stays at the radial span of one frame (~230 MiB at 1920x1080). The samples are iterated relative to a reference
+ * orbit of the center (see PerturbationKernel), which works at any depth.
+ */
+class ExponentialMap {
+    public:
+        /**
+         * Compute the reference orbit of the center.
+         *
+         * @param p_real Center of the zoom, with the precision of the deepest frame.
+         * @param p_imaginary Center of the zoom.
+         * @param p_anchor Radius of ring 0, e.g. the outer corner of the first frame.
+         * @param p_angles Samples per ring, see getAnglesFor.
+         * @param p_maxIterations Iteration limit of the samples, the highest limit of all frames.
+         */
+        ExponentialMap(const FixedPoint& p_real,
+                       const FixedPoint& p_imaginary,
+                       const FloatExp& p_anchor,
+                       int p_angles,
+                       int p_maxIterations);
+
+        /**
+         * @return Samples per ring, so that a frame of this size is sampled at least once per pixel.
+         */
+        static int getAnglesFor(int p_width, int p_height);
+
+        /**
+         * Resample a frame of the zoom, computing the rings it needs first.
+         *
+         * @param p_pixelSize Distance between two neighbouring pixels of the frame.
+         * @param p_maxIterations Iteration limit of the frame, higher counts of the samples are clamped to it.
+         * @param p_buffer Destination, its size defines the resolution of the frame.
+         * @param p_regions The pixels to fill.
+         */
+        void renderFrame(const FloatExp& p_pixelSize,
+                         int p_maxIterations,
+                         IterationBuffer& p_buffer,
+                         const std::vector<Tile>& p_regions,
+                         TileScheduler& p_scheduler);
+
+        /**
+         * @return Number of samples iterated so far.
+         */
+        uint64_t getComputedSamples() const { return _computedSamples; }
+
+    private:
+        // Make rings p_first ... p_last available, drop the rings before p_first
+        void prepareRings(int p_first, int p_last, TileScheduler& p_scheduler);
+
+        // Iterate the rings p_first ... p_last into p_rings
+        void computeRings(int p_first, int p_last, std::vector<std::vector<uint32_t>>& p_rings,
+                          TileScheduler& p_scheduler);
+
+        FloatExp getRingRadius(int p_ring) const;
+
+        // Ring index (fractional) of a radius
+        double getRingPosition(const FloatExp& p_radius) const;
+
+        int _angles;
+        double _step;
+        FloatExp _anchor;
+        int _maxIterations;
+
+        ReferenceOrbit _orbit;
+        // Rebuilt, whenever the rings get much smaller (or larger) than the table's |dc|
+        BilinearApproximation _approximation;
+        bool _approximationValid = false;
+
+        // Rings _firstRing, _firstRing + 1, ...
+        std::deque<std::vector<uint32_t>> _rings;
+        int _firstRing = 0;
+        uint64_t _computedSamples = 0;
+};
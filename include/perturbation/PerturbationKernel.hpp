@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cpu/IEscapeTimeKernel.hpp>
+#include <perturbation/BilinearApproximation.hpp>
+#include <perturbation/ReferenceOrbit.hpp>
+#include <precision/FloatExp.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+/**
+ * Per frame counters of the perturbation loop.
+ */
+struct PerturbationStatistics {
+        // Iterations skipped by the BLA table
+        uint64_t skippedIterations = 0;
+        // Pixels switching back to the start of the reference orbit
+        uint64_t rebases = 0;
+};
+
+/**
+ * Deep zoom kernel based on perturbation theory.
+ *
+ * Instead of z_n, every pixel iterates its difference d_n = z_n - Z_n to a ReferenceOrbit:
+ * d_(n+1) = 2 * Z_n * d_n + d_n^2 + dc
+ * The differences are tiny and therefore well representable in double precision, no matter how deep the zoom is.
+ *
+ * With a BilinearApproximation table, runs of iterations, which are nearly linear in d, are skipped at once.
+ *
+ * Glitches (d losing its precision against Z) are avoided by rebasing: as soon as |z| < |d| or the reference orbit
+ * ends, the pixel continues with d = z relative to Z_0 = 0. A single reference orbit therefore suffices for the whole
+ * frame, no matter where it escapes.
+ *
+ * Beyond the double range (dc below ~1e-270) the pixel starts in FloatExp arithmetic and switches to doubles as soon
+ * as d has grown large enough, usually after a few hundred iterations.
+ */
+class PerturbationKernel : public IEscapeTimeKernel {
+    public:
+        /**
+         * Select the reference orbit for the following frames.
+         *
+         * @param p_orbit The reference orbit, must outlive the rendering.
+         * @param p_offset Viewport center minus the reference point.
+         * @param p_approximation BLA table of the orbit or nullptr to iterate every step.
+         */
+        void setReference(const ReferenceOrbit* p_orbit,
+                          std::pair<FloatExp, FloatExp> p_offset,
+                          const BilinearApproximation* p_approximation = nullptr) {
+            _orbit = p_orbit;
+            _offset = p_offset;
+            _approximation = p_approximation;
+        }
+
+        /**
+         * @return Counters accumulated since the last reset.
+         */
+        PerturbationStatistics getStatistics() const { return {_skippedIterations, _rebases}; }
+
+        /**
+         * Reset the statistics (e.g. at the start of every frame).
+         */
+        void resetStatistics() {
+            _skippedIterations = 0;
+            _rebases = 0;
+        }
+
+        void renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) override;
+
+        /**
+         * Iterate a single pixel.
+         *
+         * @param p_orbit The reference orbit.
+         * @param p_approximation BLA table of the orbit or nullptr.
+         * @param p_deltaReal Real part of c minus the reference point.
+         * @param p_deltaImaginary Imaginary part of c minus the reference point.
+         * @param p_maxIterations Maximum iteration count.
+         * @param p_statistics Receives the skipped iterations and rebases of the pixel.
+         *
+         * @return The number of iterations before the orbit escaped.
+         */
+        static uint32_t iterate(const ReferenceOrbit& p_orbit,
+                                const BilinearApproximation* p_approximation,
+                                double p_deltaReal,
+                                double p_deltaImaginary,
+                                int p_maxIterations,
+                                PerturbationStatistics& p_statistics);
+
+        /**
+         * Same as iterate, for deltas which would underflow doubles.
+         */
+        static uint32_t iterateExtended(const ReferenceOrbit& p_orbit,
+                                        const BilinearApproximation* p_approximation,
+                                        const FloatExp& p_deltaReal,
+                                        const FloatExp& p_deltaImaginary,
+                                        int p_maxIterations,
+                                        PerturbationStatistics& p_statistics);
+
+        /**
+         * Smallest binary exponent of dc and d, for which the double loop is used (d^2 may underflow there, it is
+         * negligible against d).
+         */
+        static constexpr int64_t minDoubleExponent = -900;
+
+    private:
+        // The double loop, continuing from iteration p_iteration at reference position p_position with delta d
+        static uint32_t iterate(const ReferenceOrbit& p_orbit,
+                                const BilinearApproximation* p_approximation,
+                                double p_deltaReal,
+                                double p_deltaImaginary,
+                                double p_dReal,
+                                double p_dImaginary,
+                                int p_iteration,
+                                int p_position,
+                                int p_maxIterations,
+                                PerturbationStatistics& p_statistics);
+
+        const ReferenceOrbit* _orbit = nullptr;
+        const BilinearApproximation* _approximation = nullptr;
+        std::pair<FloatExp, FloatExp> _offset;
+
+        std::atomic<uint64_t> _skippedIterations{0};
+        std::atomic<uint64_t> _rebases{0};
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <precision/FixedPoint.hpp>
+
+#include <vector>
+
+/**
+ * Orbit Z_n of a single reference point, computed in arbitrary precision and stored in double precision.
+ *
+ * Pixels close to the reference only iterate their (small) difference to this orbit, see PerturbationKernel.
+ */
+class ReferenceOrbit {
+    public:
+        /**
+         * Iterate the reference point until it escapes or reaches the maximum iteration count.
+         *
+         * @param p_real Real part of the reference point.
+         * @param p_imaginary Imaginary part of the reference point.
+         * @param p_maxIterations Maximum iteration count.
+         */
+        void compute(const FixedPoint& p_real, const FixedPoint& p_imaginary, int p_maxIterations);
+
+        /**
+         * @return Number of stored values Z_0 ... Z_(length - 1). 0 if nothing has been computed yet.
+         */
+        int getLength() const { return static_cast<int>(_values.size() / 2); }
+
+        double getReal(int p_iteration) const { return _values[2 * p_iteration]; }
+        double getImaginary(int p_iteration) const { return _values[2 * p_iteration + 1]; }
+
+        /**
+         * @return Z_n as interleaved (real, imaginary) pairs, ready to be uploaded to the GPU.
+         */
+        const std::vector<double>& getValues() const { return _values; }
+
+        const FixedPoint& getCenterReal() const { return _real; }
+        const FixedPoint& getCenterImaginary() const { return _imaginary; }
+
+        /**
+         * @return The maximum iteration count the orbit has been computed for.
+         */
+        int getMaxIterations() const { return _maxIterations; }
+
+        /**
+         * @return true, if the reference escaped before reaching the maximum iteration count.
+         */
+        bool hasEscaped() const { return _escaped; }
+
+    private:
+        FixedPoint _real;
+        FixedPoint _imaginary;
+        int _maxIterations = 0;
+        bool _escaped = false;
+
+        std::vector<double> _values;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <precision/FixedPoint.hpp>
+
+#include <cmath>
+
+/**
+ * Unevaluated sum of two doubles (high + low, |low| <= ulp(high) / 2), about 106 significant bits.
+ *
+ * Much cheaper than FixedPoint and sufficient for zooms down to ~1e-28, where perturbation takes over.
+ * Products use FMA to obtain the exact rounding error, if the platform provides a fast one (FP_FAST_FMA), and
+ * Dekker's splitting otherwise.
+ */
+struct DoubleDouble {
+        double high;
+        double low;
+
+        DoubleDouble(double p_high = 0.0, double p_low = 0.0) : high(p_high), low(p_low) {}
+
+        /**
+         * Round an arbitrary precision number to the nearest double-double.
+         */
+        static DoubleDouble fromFixedPoint(const FixedPoint& p_value) {
+            const double high = p_value.toDouble();
+            const double low = (p_value - FixedPoint(high, p_value.getFractionLimbs())).toDouble();
+            return quickTwoSum(high, low);
+        }
+
+        double toDouble() const { return high + low; }
+
+        /**
+         * s + e == a + b exactly.
+         */
+        static DoubleDouble twoSum(double p_a, double p_b) {
+            const double sum = p_a + p_b;
+            const double b = sum - p_a;
+            return {sum, (p_a - (sum - b)) + (p_b - b)};
+        }
+
+        /**
+         * Same as twoSum, requires |a| >= |b|.
+         */
+        static DoubleDouble quickTwoSum(double p_a, double p_b) {
+            const double sum = p_a + p_b;
+            return {sum, p_b - (sum - p_a)};
+        }
+
+        /**
+         * p + e == a * b exactly.
+         */
+        static DoubleDouble twoProduct(double p_a, double p_b) {
+            const double product = p_a * p_b;
+#if defined(FP_FAST_FMA)
+            return {product, std::fma(p_a, p_b, -product)};
+#else
+            // Dekker: split both factors into 26-bit halves, whose products are exact
+            constexpr double splitter = 134217729.0;  // 2^27 + 1
+            const double aScaled = splitter * p_a;
+            const double aHigh = aScaled - (aScaled - p_a);
+            const double aLow = p_a - aHigh;
+            const double bScaled = splitter * p_b;
+            const double bHigh = bScaled - (bScaled - p_b);
+            const double bLow = p_b - bHigh;
+            return {product, ((aHigh * bHigh - product) + aHigh * bLow + aLow * bHigh) + aLow * bLow};
+#endif
+        }
+
+        DoubleDouble operator+(const DoubleDouble& p_other) const {
+            DoubleDouble sum = twoSum(high, p_other.high);
+            const DoubleDouble lowSum = twoSum(low, p_other.low);
+            sum.low += lowSum.high;
+            sum = quickTwoSum(sum.high, sum.low);
+            sum.low += lowSum.low;
+            return quickTwoSum(sum.high, sum.low);
+        }
+
+        DoubleDouble operator-() const { return {-high, -low}; }
+        DoubleDouble operator-(const DoubleDouble& p_other) const { return *this + -p_other; }
+
+        DoubleDouble operator*(const DoubleDouble& p_other) const {
+            DoubleDouble product = twoProduct(high, p_other.high);
+            product.low += high * p_other.low + low * p_other.high;
+            return quickTwoSum(product.high, product.low);
+        }
+
+        /**
+         * Exact multiplication by 2.
+         */
+        DoubleDouble twice() const { return {2.0 * high, 2.0 * low}; }
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <precision/FloatExp.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Arbitrary precision signed fixed-point number, tuned for the Mandelbrot iteration (no GMP/MPFR dependency).
+ *
+ * Stored as sign and magnitude. The magnitude consists of one 64-bit integer limb and a configurable number of 64-bit
+ * fraction limbs, least significant limb first. Values of the Mandelbrot iteration never leave [-2^64, 2^64], so a
+ * single integer limb suffices and the precision only has to grow with the zoom depth.
+ *
+ * Products are accumulated in 128 bits (unsigned __int128 where available). Squaring only computes the products
+ * above the diagonal once, large operands switch from schoolbook to Karatsuba multiplication.
+ *
+ * Operands of different precision are extended to the higher precision, results are truncated.
+ */
+class FixedPoint {
+    public:
+        /**
+         * Zero with the given precision.
+         *
+         * @param p_fractionLimbs Number of 64-bit limbs after the binary point.
+         */
+        explicit FixedPoint(int p_fractionLimbs = 1);
+
+        /**
+         * Exact conversion of a double (as long as p_fractionLimbs covers its lowest bit).
+         */
+        FixedPoint(double p_value, int p_fractionLimbs);
+
+        /**
+         * Conversion of an extended exponent number, bits below the precision are truncated.
+         */
+        FixedPoint(const FloatExp& p_value, int p_fractionLimbs);
+
+        /**
+         * @return The nearest double (truncated to 53 significant bits).
+         */
+        double toDouble() const;
+
+        /**
+         * @return The value with 53 significant bits, without underflow (unlike toDouble).
+         */
+        FloatExp toFloatExp() const;
+
+        /**
+         * Decimal representation.
+         *
+         * @param p_digits Number of digits after the decimal point.
+         */
+        std::string toString(int p_digits) const;
+
+        /**
+         * Parse a decimal representation (e.g. of toString), digits below the precision are truncated.
+         *
+         * @throws std::invalid_argument, if p_text isn't a plain decimal number.
+         */
+        static FixedPoint fromString(const std::string& p_text, int p_fractionLimbs);
+
+        /**
+         * Change the precision. Lowering it truncates the value.
+         */
+        void setFractionLimbs(int p_fractionLimbs);
+        int getFractionLimbs() const { return static_cast<int>(_limbs.size()) - 1; }
+
+        /**
+         * Number of 64-bit fraction limbs needed to resolve differences of p_resolution with a safety margin.
+         */
+        static int fractionLimbsFor(const FloatExp& p_resolution);
+
+        bool isNegative() const { return _negative; }
+        bool isZero() const;
+
+        FixedPoint operator-() const;
+        FixedPoint operator+(const FixedPoint& p_other) const;
+        FixedPoint operator-(const FixedPoint& p_other) const;
+        FixedPoint operator*(const FixedPoint& p_other) const;
+        FixedPoint& operator+=(const FixedPoint& p_other) { return accumulate(p_other, false); }
+        FixedPoint& operator-=(const FixedPoint& p_other) { return accumulate(p_other, true); }
+
+        bool operator==(const FixedPoint& p_other) const;
+        bool operator!=(const FixedPoint& p_other) const { return !(*this == p_other); }
+
+        /**
+         * @return this * this, roughly half the cost of a general multiplication.
+         */
+        FixedPoint square() const;
+
+        /**
+         * this = p_value * p_value without allocating (once p_scratch and this have grown to the required size).
+         *
+         * @param p_value The number to square, must not be this.
+         * @param p_scratch Reusable buffer for the full product.
+         */
+        void assignSquare(const FixedPoint& p_value, std::vector<uint64_t>& p_scratch);
+
+        /**
+         * @return this * 2 (used for the 2 * zr * zi term of the iteration).
+         */
+        FixedPoint twice() const;
+
+        /**
+         * @return this / 2 (truncated).
+         */
+        FixedPoint half() const;
+
+        /**
+         * Full product of two magnitudes with p_size limbs each, p_result receives 2 * p_size limbs.
+         */
+        static void multiplyMagnitudes(const uint64_t* p_a, const uint64_t* p_b, size_t p_size, uint64_t* p_result);
+
+        /**
+         * Full square of a magnitude with p_size limbs, p_result receives 2 * p_size limbs.
+         */
+        static void squareMagnitude(const uint64_t* p_a, size_t p_size, uint64_t* p_result);
+
+    private:
+        // Compare magnitudes of two numbers with equal precision: -1, 0, 1
+        static int compareMagnitude(const std::vector<uint64_t>& p_a, const std::vector<uint64_t>& p_b);
+
+        // Add the magnitude of p_b to p_a (equal precision)
+        static void addMagnitude(std::vector<uint64_t>& p_a, const std::vector<uint64_t>& p_b);
+
+        // Subtract the magnitude of p_b from the larger p_a (equal precision)
+        static void subtractMagnitude(std::vector<uint64_t>& p_a, const std::vector<uint64_t>& p_b);
+
+        // In-place signed addition, p_other is negated if p_subtract is set
+        FixedPoint& accumulate(const FixedPoint& p_other, bool p_subtract);
+
+        // Copy with at least the given precision
+        FixedPoint withFractionLimbs(int p_fractionLimbs) const;
+
+        // Keep the integer limb and the top fraction limbs of a full product with 2 * fractionLimbs fraction limbs
+        static FixedPoint fromProduct(const std::vector<uint64_t>& p_product, int p_fractionLimbs, bool p_negative);
+
+        bool _negative = false;
+
+        // Least significant limb first, the last limb is the integer part
+        std::vector<uint64_t> _limbs;
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+/**
+ * Double mantissa with a separate 64-bit binary exponent: mantissa * 2^exponent.
+ *
+ * Keeps 53 significant bits far below the smallest double (~1e-308), which perturbation deltas and pixel sizes of
+ * very deep zooms reach. The mantissa is normalized to [1, 2) (or 0 for zero) by rewriting its exponent bits, so
+ * every operation is a handful of integer and floating point instructions without calls to frexp/ldexp.
+ */
+struct FloatExp {
+        // Exponent of zero, far enough from the int64_t range that sums of exponents can't overflow
+        static constexpr int64_t zeroExponent = INT64_MIN / 4;
+
+        double mantissa;
+        int64_t exponent;
+
+        FloatExp() : mantissa(0.0), exponent(zeroExponent) {}
+        FloatExp(double p_value) : FloatExp(normalized(p_value, 0)) {}
+
+        /**
+         * p_mantissa * 2^p_exponent, p_mantissa may be any finite normal double or 0.
+         */
+        static FloatExp normalized(double p_mantissa, int64_t p_exponent) {
+            uint64_t bits;
+            std::memcpy(&bits, &p_mantissa, sizeof(bits));
+            const int64_t biasedExponent = static_cast<int64_t>((bits >> 52) & 0x7FF);
+            if (biasedExponent == 0) return {};
+
+            bits = (bits & 0x800FFFFFFFFFFFFFull) | (1023ull << 52);
+            FloatExp result;
+            std::memcpy(&result.mantissa, &bits, sizeof(bits));
+            result.exponent = p_exponent + biasedExponent - 1023;
+            return result;
+        }
+
+        bool isZero() const { return mantissa == 0.0; }
+
+        /**
+         * @return The nearest double, 0 below and infinity above the double range.
+         */
+        double toDouble() const {
+            if (exponent < -1100) return 0.0;
+            if (exponent > 1100) return mantissa * INFINITY;
+            return std::ldexp(mantissa, static_cast<int>(exponent));
+        }
+
+        /**
+         * Natural logarithm of the absolute value.
+         */
+        double log() const { return std::log(std::fabs(mantissa)) + static_cast<double>(exponent) * std::log(2.0); }
+
+        /**
+         * Scientific notation, e.g. 1.2345e-400.
+         */
+        std::string toString() const {
+            if (isZero()) return "0";
+            const double decimalLog = log() / std::log(10.0);
+            const double decimalExponent = std::floor(decimalLog);
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "%s%.4fe%.0f", mantissa < 0.0 ? "-" : "",
+                          std::pow(10.0, decimalLog - decimalExponent), decimalExponent);
+            return buffer;
+        }
+
+        /**
+         * Parse scientific notation (see toString), the exponent may be beyond the double range.
+         *
+         * @throws std::invalid_argument, if p_text isn't a number.
+         */
+        static FloatExp fromString(const std::string& p_text) {
+            const size_t separator = std::min(p_text.find_first_of("eE"), p_text.size());
+            size_t mantissaEnd = 0;
+            size_t exponentEnd = 0;
+            const std::string mantissaText = p_text.substr(0, separator);
+            const double decimalMantissa = std::stod(mantissaText, &mantissaEnd);
+            const long long decimalExponent =
+                separator < p_text.size() ? std::stoll(p_text.substr(separator + 1), &exponentEnd) : 0;
+            if (mantissaEnd != mantissaText.size() ||
+                (separator < p_text.size() && exponentEnd != p_text.size() - separator - 1)) {
+                throw std::invalid_argument("Not a number: " + p_text);
+            }
+
+            // 10^|exponent| by repeated squaring
+            FloatExp power = 1.0;
+            FloatExp base = 10.0;
+            for (unsigned long long remaining = std::llabs(decimalExponent); remaining > 0; remaining >>= 1) {
+                if (remaining & 1) power *= base;
+                base *= base;
+            }
+            return decimalExponent < 0 ? FloatExp(decimalMantissa) / power : FloatExp(decimalMantissa) * power;
+        }
+
+        FloatExp operator-() const { return {-mantissa, exponent}; }
+        FloatExp abs() const { return {std::fabs(mantissa), exponent}; }
+
+        FloatExp operator+(const FloatExp& p_other) const {
+            // Align the smaller operand, beyond 64 bits difference it can't change the result anymore
+            const bool larger = exponent >= p_other.exponent;
+            const FloatExp& big = larger ? *this : p_other;
+            const FloatExp& small = larger ? p_other : *this;
+            const int64_t difference = big.exponent - small.exponent;
+            if (difference > 64) return big;
+            return normalized(big.mantissa + small.mantissa * powerOfTwo(-difference), big.exponent);
+        }
+
+        FloatExp operator-(const FloatExp& p_other) const { return *this + -p_other; }
+
+        FloatExp operator*(const FloatExp& p_other) const {
+            return normalized(mantissa * p_other.mantissa, exponent + p_other.exponent);
+        }
+
+        FloatExp operator/(const FloatExp& p_other) const {
+            return normalized(mantissa / p_other.mantissa, exponent - p_other.exponent);
+        }
+
+        FloatExp& operator*=(const FloatExp& p_other) { return *this = *this * p_other; }
+        FloatExp& operator/=(const FloatExp& p_other) { return *this = *this / p_other; }
+
+        /**
+         * Exact multiplication by 2.
+         */
+        FloatExp twice() const { return isZero() ? *this : FloatExp{mantissa, exponent + 1}; }
+
+        bool operator<(const FloatExp& p_other) const { return (*this - p_other).mantissa < 0.0; }
+        bool operator>(const FloatExp& p_other) const { return p_other < *this; }
+
+    private:
+        FloatExp(double p_mantissa, int64_t p_exponent) : mantissa(p_mantissa), exponent(p_exponent) {}
+
+        // 2^p_exponent for -1022 <= p_exponent <= 1023, built from the exponent bits
+        static double powerOfTwo(int64_t p_exponent) {
+            const uint64_t bits = static_cast<uint64_t>(p_exponent + 1023) << 52;
+            double result;
+            std::memcpy(&result, &bits, sizeof(result));
+            return result;
+        }
+};
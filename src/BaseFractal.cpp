@@ -1,10 +1,22 @@
 #pragma once
 #include <BaseFractal.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
 BaseFractal::~BaseFractal() {
     glDeleteVertexArrays(1, &_VAO);
     glDeleteBuffers(1, &_VBO);
     glDeleteBuffers(1, &_EBO);
+    glDeleteTextures(1, &_iterationTexture);
+    glDeleteFramebuffers(2, _framebuffers);
+    glDeleteTextures(2, _colorTextures);
+    glDeleteTextures(MAX_DOUBLE_BUFFERS, _doubleTextures);
+    glDeleteBuffers(MAX_DOUBLE_BUFFERS, _doubleBuffers);
+    glDeleteFramebuffers(GUESS_LEVELS, _guessFramebuffers);
+    glDeleteTextures(GUESS_LEVELS, _guessTextures);
+    glDeleteQueries(1, &_guessQuery);
     glDeleteProgram(_shaderProgram);
 
     glfwDestroyWindow(_window);
@@ -12,6 +24,10 @@ BaseFractal::~BaseFractal() {
 }
 
 void BaseFractal::initializeWindow(const std::string& p_windowTitle) {
+#if defined(GLFW_PLATFORM_NULL)
+    // No display connection at all, the window only carries the context
+    if (_headless) { glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL); }
+#endif
     if (!glfwInit()) { throw WindowInitializationError(); }
 
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -19,13 +35,25 @@ void BaseFractal::initializeWindow(const std::string& p_windowTitle) {
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
     glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
+    if (_headless) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    }
     _window = glfwCreateWindow(_width, _height, p_windowTitle.c_str(), nullptr, nullptr);
+    if (!_window && _headless) {
+        // No EGL driver, fall back to software rendering
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+        _window = glfwCreateWindow(_width, _height, p_windowTitle.c_str(), nullptr, nullptr);
+    }
     if (!_window) {
         glfwTerminate();
         throw WindowCreationError();
     }
     glfwMakeContextCurrent(_window);
     gladLoadGL();
+
+    glfwSetWindowUserPointer(_window, this);
+    glfwSetWindowRefreshCallback(_window, onWindowRefresh);
 }
 
 void BaseFractal::createShaderProgram() {
@@ -63,6 +91,8 @@ void BaseFractal::createShaderProgram() {
     // Cleanup shaders as they're now linked into our program
     glDeleteShader(_vertexShader);
     glDeleteShader(_fragmentShader);
+
+    _uniforms.resolve(_shaderProgram);
 }
 
 void BaseFractal::setupBuffers() {
@@ -95,6 +125,54 @@ void BaseFractal::setupBuffers() {
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // Texture receiving the iteration counts of the CPU backend
+    glGenTextures(1, &_iterationTexture);
+    glBindTexture(GL_TEXTURE_2D, _iterationTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, _width, _height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+    // Offscreen targets of the progressive passes and pans
+    glGenTextures(2, _colorTextures);
+    glGenFramebuffers(2, _framebuffers);
+    for (int i = 0; i < 2; i++) {
+        glBindTexture(GL_TEXTURE_2D, _colorTextures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, _width, _height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, _framebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _colorTextures[i], 0);
+    }
+
+    // Coarse iteration levels of the solid guessing, they only receive output location 1 (the iteration count)
+    glGenTextures(GUESS_LEVELS, _guessTextures);
+    glGenFramebuffers(GUESS_LEVELS, _guessFramebuffers);
+    const GLenum guessDrawBuffers[] = {GL_NONE, GL_COLOR_ATTACHMENT0};
+    for (int i = 0; i < GUESS_LEVELS; i++) {
+        glBindTexture(GL_TEXTURE_2D, _guessTextures[i]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D,
+                     0,
+                     GL_R32UI,
+                     std::max(1, static_cast<int>(_width) >> (i + 1)),
+                     std::max(1, static_cast<int>(_height) >> (i + 1)),
+                     0,
+                     GL_RED_INTEGER,
+                     GL_UNSIGNED_INT,
+                     nullptr);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, _guessFramebuffers[i]);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _guessTextures[i], 0);
+        glDrawBuffers(2, guessDrawBuffers);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glGenQueries(1, &_guessQuery);
 }
 
 void BaseFractal::renderFractal() {
@@ -103,18 +181,344 @@ void BaseFractal::renderFractal() {
 
         if (glfwGetKey(_window, GLFW_KEY_ESCAPE) == GLFW_PRESS) glfwSetWindowShouldClose(_window, true);
 
-        glClear(GL_COLOR_BUFFER_BIT);
+        // A changed view starts over with the coarsest pass, so only previews are drawn while it keeps changing
+        if (_redrawRequested || !_renderOnDemand) {
+            _nextPass = _progressive && _renderOnDemand ? COARSEST_PASS : 0;
+            _redrawRequested = false;
+            _panX = 0;
+            _panY = 0;
+            _zoomFactor = 1.0;
+            _zoomRequested = false;
+        }
 
-        glUseProgram(_shaderProgram);
+        if (_zoomRequested) {
+            _zoomRequested = false;
+            const int reuseFactor = static_cast<int>(_zoomFactor);
+            const bool complete = _nextPass < 0 && _renderWidth == static_cast<int>(_width);
+            if (_backend == RenderBackend::CPU && complete && reuseFactor == _zoomFactor && reuseFactor % 2 == 1) {
+                renderZoomReuse(reuseFactor);
+            } else if (_zoomFactor < 0.5 || _zoomFactor > 1.25) {
+                // The preview got too blurry (or its borders too wide), recompute cheaply and refine from there
+                renderPass(ZOOM_PASS);
+                _nextPass = ZOOM_PASS - 1;
+            } else {
+                // Refinement starts at the first pass at least as sharp as the preview
+                const double previewWidth = _renderWidth * _zoomFactor;
+                _nextPass = 0;
+                while (_nextPass < COARSEST_PASS && (static_cast<int>(_width) >> (_nextPass + 1)) >= previewWidth) {
+                    _nextPass++;
+                }
+            }
+            present();
+        } else if (_nextPass >= 0) {
+            renderPass(_nextPass--);
+            present();
+        } else if (_panX != 0 || _panY != 0) {
+            renderPan();
+            present();
+        } else if (_presentRequested) {
+            present();
+        }
+        _presentRequested = false;
+
+        // Nothing left to refine: sleep until the next input event instead of drawing the same frame again
+        if (_renderOnDemand && _nextPass < 0) {
+            glfwWaitEvents();
+        } else {
+            glfwPollEvents();
+        }
+
+        doOnRenderEnd();
+    }
+}
+
+Image BaseFractal::captureFrame() {
+    renderPass(0);
+
+    // The offscreen target now holds the complete image, nothing left to refine
+    _nextPass = -1;
+    _redrawRequested = false;
+    _panX = 0;
+    _panY = 0;
+    _zoomRequested = false;
+    _presentRequested = true;
+
+    Image image;
+    image.width = _renderWidth;
+    image.height = _renderHeight;
+    image.pixels.resize(static_cast<size_t>(image.width) * image.height * 3);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _framebuffers[_currentTarget]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, image.width, image.height, GL_RGB, GL_UNSIGNED_BYTE, image.pixels.data());
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    // OpenGL rows are bottom-up
+    const size_t rowSize = static_cast<size_t>(image.width) * 3;
+    for (int y = 0; y < image.height / 2; y++) {
+        std::swap_ranges(image.pixels.begin() + y * rowSize,
+                         image.pixels.begin() + (y + 1) * rowSize,
+                         image.pixels.begin() + (image.height - 1 - y) * rowSize);
+    }
+    return image;
+}
+
+void BaseFractal::renderPass(int p_pass) {
+    _renderWidth = std::max(1, static_cast<int>(_width) >> p_pass);
+    _renderHeight = std::max(1, static_cast<int>(_height) >> p_pass);
+
+    _zoomFactor = 1.0;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffers[_currentTarget]);
+    glClear(GL_COLOR_BUFFER_BIT);
+    const std::vector<Tile> frame = {{0, 0, _renderWidth, _renderHeight}};
+    drawRegions(frame, frame);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void BaseFractal::requestPan(int p_dx, int p_dy) {
+    // Only a complete full resolution image can be shifted
+    const bool complete = _nextPass < 0 && _renderWidth == static_cast<int>(_width) &&
+                          _renderHeight == static_cast<int>(_height);
+    _panX += p_dx;
+    _panY += p_dy;
+    if (!complete || std::abs(_panX) >= _renderWidth || std::abs(_panY) >= _renderHeight) { requestRedraw(); }
+}
+
+void BaseFractal::requestZoom(double p_factor) {
+    // Nothing to rescale yet
+    if (_renderWidth == 0) {
+        requestRedraw();
+        return;
+    }
+    _zoomFactor *= p_factor;
+    _zoomRequested = true;
+}
+
+void BaseFractal::renderPan() {
+    const int width = _renderWidth;
+    const int height = _renderHeight;
+    const int dx = _panX;
+    const int dy = _panY;
+    _panX = 0;
+    _panY = 0;
+
+    // Moving the view right moves the image left: the pixel at (x + dx, y + dy) ends up at (x, y)
+    const int target = 1 - _currentTarget;
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _framebuffers[_currentTarget]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _framebuffers[target]);
+    glBlitFramebuffer(std::max(0, dx),
+                      std::max(0, dy),
+                      width + std::min(0, dx),
+                      height + std::min(0, dy),
+                      std::max(0, -dx),
+                      std::max(0, -dy),
+                      width - std::max(0, dx),
+                      height - std::max(0, dy),
+                      GL_COLOR_BUFFER_BIT,
+                      GL_NEAREST);
+    _currentTarget = target;
+    if (_backend == RenderBackend::CPU) { _iterationBuffer.shift(-dx, -dy); }
+
+    // Exposed column strip and the rest of the exposed row strip
+    std::vector<Tile> regions;
+    if (dx != 0) { regions.push_back({dx > 0 ? width - dx : 0, 0, std::abs(dx), height}); }
+    if (dy != 0) {
+        regions.push_back({std::max(0, -dx), dy > 0 ? height - dy : 0, width - std::abs(dx), std::abs(dy)});
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffers[_currentTarget]);
+    drawRegions(regions, regions);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void BaseFractal::renderZoomReuse(int p_factor) {
+    _zoomFactor = 1.0;
+    const Tile kept = _iterationBuffer.shrink(p_factor);
+
+    // The frame around the kept block: bottom and top rows, left and right of the block
+    std::vector<Tile> regions;
+    const int keptTop = kept.y + kept.height;
+    const int keptRight = kept.x + kept.width;
+    if (kept.y > 0) { regions.push_back({0, 0, _renderWidth, kept.y}); }
+    if (keptTop < _renderHeight) { regions.push_back({0, keptTop, _renderWidth, _renderHeight - keptTop}); }
+    if (kept.x > 0) { regions.push_back({0, kept.y, kept.x, kept.height}); }
+    if (keptRight < _renderWidth) { regions.push_back({keptRight, kept.y, _renderWidth - keptRight, kept.height}); }
+
+    // The colors depend on the iteration limit, the kept block is redrawn as well
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffers[_currentTarget]);
+    drawRegions(regions, {{0, 0, _renderWidth, _renderHeight}});
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void BaseFractal::drawRegions(const std::vector<Tile>& p_computeRegions, const std::vector<Tile>& p_drawRegions) {
+    glViewport(0, 0, _renderWidth, _renderHeight);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, _iterationTexture);
+    _iterationBuffer.resize(_renderWidth, _renderHeight);
+    // The GPU backend draws from the iteration counts as well, if they are cached for the whole area
+    _iterationTextureUsed = _backend == RenderBackend::CPU || lookupIterations(_iterationBuffer, p_drawRegions);
+    if (_backend == RenderBackend::CPU) { computeIterations(_iterationBuffer, p_computeRegions); }
+    if (_iterationTextureUsed) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage2D(GL_TEXTURE_2D,
+                        0,
+                        0,
+                        0,
+                        _iterationBuffer.getWidth(),
+                        _iterationBuffer.getHeight(),
+                        GL_RED_INTEGER,
+                        GL_UNSIGNED_INT,
+                        _iterationBuffer.getData());
+    }
+
+    glUseProgram(_shaderProgram);
+    if (_solidGuessing && !_iterationTextureUsed) {
+        drawGuessed(p_drawRegions);
+        return;
+    }
+    setUniforms();
+    _guessPassUniform.set(0);
+    drawQuad(p_drawRegions);
+    _guessRegions.clear();
+}
+
+void BaseFractal::drawGuessed(const std::vector<Tile>& p_regions) {
+    const int width = _renderWidth;
+    const int height = _renderHeight;
+
+    // Every level covers the neighbourhoods of the next finer one: half its regions, grown by a pixel
+    std::vector<Tile> levelRegions[GUESS_LEVELS + 1];
+    levelRegions[0] = p_regions;
+    for (int level = 1; level <= GUESS_LEVELS; level++) {
+        const int levelWidth = std::max(1, width >> level);
+        const int levelHeight = std::max(1, height >> level);
+        for (const Tile& region : levelRegions[level - 1]) {
+            const int x = std::max(0, (region.x >> 1) - 1);
+            const int y = std::max(0, (region.y >> 1) - 1);
+            const int right = std::min(levelWidth, ((region.x + region.width - 1) >> 1) + 2);
+            const int top = std::min(levelHeight, ((region.y + region.height - 1) >> 1) + 2);
+            levelRegions[level].push_back({x, y, right - x, top - y});
+        }
+    }
+
+    // Coarsest level first, the uniforms follow the resolution of the level being drawn
+    for (int level = GUESS_LEVELS; level >= 0; level--) {
+        _renderWidth = std::max(1, width >> level);
+        _renderHeight = std::max(1, height >> level);
+        glBindFramebuffer(GL_FRAMEBUFFER, level > 0 ? _guessFramebuffers[level - 1] : _framebuffers[_currentTarget]);
+        glViewport(0, 0, _renderWidth, _renderHeight);
         setUniforms();
 
-        glBindVertexArray(_VAO);
+        if (level < GUESS_LEVELS) {
+            glActiveTexture(GL_TEXTURE0 + GUESS_TEXTURE_UNIT);
+            glBindTexture(GL_TEXTURE_2D, _guessTextures[level]);
+            glActiveTexture(GL_TEXTURE0);
+            _coarseIterationsUniform.set(GUESS_TEXTURE_UNIT);
+        }
+        _guessPassUniform.set(level < GUESS_LEVELS ? 1 : 0);
+        drawQuad(levelRegions[level]);
+    }
+    _renderWidth = width;
+    _renderHeight = height;
+
+    _guessRegions = p_regions;
+    _guessCounted = false;
+}
+
+void BaseFractal::drawQuad(const std::vector<Tile>& p_regions) {
+    // The fragment shader only runs inside of the regions, the rest of the target keeps its pixels
+    glEnable(GL_SCISSOR_TEST);
+    glBindVertexArray(_VAO);
+    for (const Tile& region : p_regions) {
+        glScissor(region.x, region.y, region.width, region.height);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+    }
+    glBindVertexArray(0);
+    glDisable(GL_SCISSOR_TEST);
+}
 
-        glfwSwapBuffers(_window);
-        glfwPollEvents();
+double BaseFractal::getGuessedFraction() {
+    uint64_t drawnPixels = 0;
+    for (const Tile& region : _guessRegions) { drawnPixels += static_cast<uint64_t>(region.width) * region.height; }
+    if (drawnPixels == 0) return 0.0;
 
-        doOnRenderEnd();
+    // Count the guessed pixels of the last pass again, the coarse levels are still intact. Only the fragments with a
+    // uniform neighbourhood pass, without writing anything.
+    if (!_guessCounted) {
+        glUseProgram(_shaderProgram);
+        glBindFramebuffer(GL_FRAMEBUFFER, _framebuffers[_currentTarget]);
+        glViewport(0, 0, _renderWidth, _renderHeight);
+        setUniforms();
+        glActiveTexture(GL_TEXTURE0 + GUESS_TEXTURE_UNIT);
+        glBindTexture(GL_TEXTURE_2D, _guessTextures[0]);
+        glActiveTexture(GL_TEXTURE0);
+        _coarseIterationsUniform.set(GUESS_TEXTURE_UNIT);
+        _guessPassUniform.set(2);
+
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glBeginQuery(GL_SAMPLES_PASSED, _guessQuery);
+        drawQuad(_guessRegions);
+        glEndQuery(GL_SAMPLES_PASSED);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        GLuint samples = 0;
+        glGetQueryObjectuiv(_guessQuery, GL_QUERY_RESULT, &samples);
+        _guessedPixels = samples;
+        _guessCounted = true;
+    }
+    return static_cast<double>(_guessedPixels) / drawnPixels;
+}
+
+void BaseFractal::present() {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, _framebuffers[_currentTarget]);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glViewport(0, 0, _width, _height);
+
+    // A pending zoom preview: the last image covers 1 / _zoomFactor of the window around the center
+    const double halfWidth = _width / 2.0 / _zoomFactor;
+    const double halfHeight = _height / 2.0 / _zoomFactor;
+    if (_zoomFactor > 1.0) { glClear(GL_COLOR_BUFFER_BIT); }
+    glBlitFramebuffer(0,
+                      0,
+                      _renderWidth,
+                      _renderHeight,
+                      std::lround(_width / 2.0 - halfWidth),
+                      std::lround(_height / 2.0 - halfHeight),
+                      std::lround(_width / 2.0 + halfWidth),
+                      std::lround(_height / 2.0 + halfHeight),
+                      GL_COLOR_BUFFER_BIT,
+                      GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glfwSwapBuffers(_window);
+}
+
+void BaseFractal::onWindowRefresh(GLFWwindow* p_window) {
+    static_cast<BaseFractal*>(glfwGetWindowUserPointer(p_window))->_presentRequested = true;
+}
+
+CpuRenderer& BaseFractal::getCpuRenderer() {
+    if (!_cpuRenderer) { _cpuRenderer = std::make_unique<CpuRenderer>(); }
+    return *_cpuRenderer;
+}
+
+void BaseFractal::uploadDoubleBuffer(int p_textureUnit, const std::vector<double>& p_values) {
+    GLuint& buffer = _doubleBuffers[p_textureUnit - 1];
+    GLuint& texture = _doubleTextures[p_textureUnit - 1];
+    if (!buffer) {
+        glGenBuffers(1, &buffer);
+        glGenTextures(1, &texture);
     }
+
+    glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+    glBufferData(GL_TEXTURE_BUFFER, p_values.size() * sizeof(double), p_values.data(), GL_DYNAMIC_DRAW);
+
+    glActiveTexture(GL_TEXTURE0 + p_textureUnit);
+    glBindTexture(GL_TEXTURE_BUFFER, texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32UI, buffer);
+    glActiveTexture(GL_TEXTURE0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
 }
\ No newline at end of file
@@ -1,7 +1,25 @@
 #pragma once
 #include <BaseFractal.hpp>
+#include <animation/FramePipeline.hpp>
+#include <animation/KeyframeTrack.hpp>
+#include <cpu/DoubleDoubleKernel.hpp>
+#include <cpu/PrecisionTier.hpp>
+#include <cpu/SimdMandelbrotKernel.hpp>
+#include <cpu/TileCache.hpp>
+#include <image/IImageWriter.hpp>
+#include <image/PosterFile.hpp>
+#include <perturbation/ExponentialMap.hpp>
+#include <perturbation/PerturbationKernel.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <sstream>
 
 class Mandelbrot : public BaseFractal {
     public:
@@ -9,11 +27,83 @@ class Mandelbrot : public BaseFractal {
             return R"(
                 #version 330 core
                 #extension GL_ARB_gpu_shader_fp64 : enable
-                out vec4 FragColor;
+                #extension GL_ARB_gpu_shader5 : enable
+                // The double-double error terms must not be reassociated or fused away
+                #ifdef GL_ARB_gpu_shader5
+                #define PRECISE precise
+                #else
+                #define PRECISE
+                #endif
+                layout(location = 0) out vec4 FragColor;
+                // Written to the coarse levels of the solid guessing (see BaseFractal::setSolidGuessing)
+                layout(location = 1) out uint FragIterations;
                 uniform vec2 u_resolution;
-                uniform vec2 u_center;
-                uniform float u_scale;
+                // doubles, split into two uints (see Uniform<double>)
+                uniform uvec2 u_centerX;
+                uniform uvec2 u_centerY;
+                uniform uvec2 u_scale;
+                // Low-order parts of the center for the double-double tier (see DoubleDouble)
+                uniform uvec2 u_centerXLow;
+                uniform uvec2 u_centerYLow;
                 uniform int u_maxIterations;
+                // Skip the main cardioid and the period-2 bulb (see MandelbrotKernel::isInMainCardioidOrBulb)
+                uniform int u_interiorCheck;
+                // Brent's cycle detection (see MandelbrotKernel::iterate, same first checkpoint), 0 disables it
+                uniform uvec2 u_periodicityTolerance;
+
+                // Solid guessing (see BaseFractal::setSolidGuessing), 0: compute, 1: guess or compute, 2: guessed only
+                uniform int u_guessPass;
+                uniform usampler2D u_coarseIterations;
+
+                // 0: compute on the GPU, 1: iteration counts computed by the CPU backend
+                uniform int u_backend;
+                uniform usampler2D u_iterations;
+
+                // See PrecisionTier: 0: plain double, 1: double-double, 2: differences to a reference orbit
+                uniform int u_precisionTier;
+                uniform usamplerBuffer u_referenceOrbit;
+                uniform int u_referenceLength;
+                uniform uvec2 u_referenceOffsetX;
+                uniform uvec2 u_referenceOffsetY;
+
+                // Bilinear approximation (see BilinearApproximation), 3 texels (A, B, radius + length) per step
+                uniform usamplerBuffer u_blaTable;
+                uniform int u_blaLevels;
+                uniform int u_blaLevelOffsets[24];
+                uniform int u_blaLevelSizes[24];
+
+                // Find the largest valid BLA step starting at iteration i, returns its first texel or -1
+                int lookupBla(int i, double deltaNorm2, int maxLength) {
+                    if (i < 1) return -1;
+                    int best = -1;
+                    for (int level = 0; level < u_blaLevels; level++) {
+                        if (((i - 1) & ((1 << level) - 1)) != 0) break;
+                        int index = (i - 1) >> level;
+                        if (index >= u_blaLevelSizes[level]) break;
+
+                        int texel = 3 * (u_blaLevelOffsets[level] + index);
+                        uvec4 radiusLength = texelFetch(u_blaTable, texel + 2);
+                        double radius = packDouble2x32(radiusLength.xy);
+                        double length = packDouble2x32(radiusLength.zw);
+                        if (length > double(maxLength) || deltaNorm2 >= radius * radius) break;
+                        best = texel;
+                    }
+                    return best;
+                }
+
+                // Count of the next coarser level, if it's uniform in the 3x3 neighbourhood of this pixel, otherwise -1
+                int guessIterations() {
+                    ivec2 size = max(ivec2(u_resolution) / 2, ivec2(1));
+                    ivec2 cell = min(ivec2(gl_FragCoord.xy) / 2, size - 1);
+                    uint count = texelFetch(u_coarseIterations, cell, 0).r;
+                    for (int y = -1; y <= 1; y++) {
+                        for (int x = -1; x <= 1; x++) {
+                            ivec2 neighbour = clamp(cell + ivec2(x, y), ivec2(0), size - 1);
+                            if (texelFetch(u_coarseIterations, neighbour, 0).r != count) return -1;
+                        }
+                    }
+                    return int(count);
+                }
 
                 vec3 getColor(float iteration, float maxIterations) {
                     float t = iteration / maxIterations;
@@ -44,73 +134,928 @@ class Mandelbrot : public BaseFractal {
                     return color;
                 }
 
-                void main() {
-                    dvec2 c = dvec2(u_center) + dvec2(gl_FragCoord.xy - u_resolution / 2.0) * double(u_scale);
+                // Double-double numbers (high, low), see DoubleDouble
+                dvec2 twoSum(double a, double b) {
+                    PRECISE double s = a + b;
+                    PRECISE double v = s - a;
+                    PRECISE double e = (a - (s - v)) + (b - v);
+                    return dvec2(s, e);
+                }
+
+                dvec2 quickTwoSum(double a, double b) {
+                    PRECISE double s = a + b;
+                    PRECISE double e = b - (s - a);
+                    return dvec2(s, e);
+                }
+
+                dvec2 ddAdd(dvec2 a, dvec2 b) {
+                    dvec2 s = twoSum(a.x, b.x);
+                    dvec2 t = twoSum(a.y, b.y);
+                    s = quickTwoSum(s.x, s.y + t.x);
+                    return quickTwoSum(s.x, s.y + t.y);
+                }
+
+                // p + e == a * b exactly (see DoubleDouble::twoProduct), fma() requires GL_ARB_gpu_shader5 as well
+                dvec2 twoProduct(double a, double b) {
+                    PRECISE double p = a * b;
+                #ifdef GL_ARB_gpu_shader5
+                    PRECISE double e = fma(a, b, -p);
+                #else
+                    // Dekker: split both factors into 26-bit halves, whose products are exact
+                    PRECISE double aScaled = 134217729.0 * a;
+                    PRECISE double aHigh = aScaled - (aScaled - a);
+                    PRECISE double aLow = a - aHigh;
+                    PRECISE double bScaled = 134217729.0 * b;
+                    PRECISE double bHigh = bScaled - (bScaled - b);
+                    PRECISE double bLow = b - bHigh;
+                    PRECISE double e = ((aHigh * bHigh - p) + aHigh * bLow + aLow * bHigh) + aLow * bLow;
+                #endif
+                    return dvec2(p, e);
+                }
+
+                dvec2 ddMul(dvec2 a, dvec2 b) {
+                    dvec2 p = twoProduct(a.x, b.x);
+                    return quickTwoSum(p.x, p.y + (a.x * b.y + a.y * b.x));
+                }
+
+                bool isInMainCardioidOrBulb(dvec2 c) {
+                    double real = c.x - 0.25;
+                    double imaginary2 = c.y * c.y;
+                    double q = real * real + imaginary2;
+                    if (q * (q + real) < 0.25 * imaginary2) return true;
+                    return (c.x + 1.0) * (c.x + 1.0) + imaginary2 < 0.0625;
+                }
+
+                // Same test in double-double (see DoubleDoubleKernel::isInMainCardioidOrBulb)
+                bool isInMainCardioidOrBulbDoubleDouble(dvec2 cx, dvec2 cy) {
+                    dvec2 real = ddAdd(cx, dvec2(-0.25, 0.0));
+                    dvec2 imaginary2 = ddMul(cy, cy);
+                    dvec2 q = ddAdd(ddMul(real, real), imaginary2);
+                    if (ddAdd(ddMul(q, ddAdd(q, real)), -0.25 * imaginary2).x < 0.0) return true;
+                    dvec2 bulbReal = ddAdd(cx, dvec2(1.0, 0.0));
+                    return ddAdd(ddAdd(ddMul(bulbReal, bulbReal), imaginary2), dvec2(-0.0625, 0.0)).x < 0.0;
+                }
+
+                int iterateDouble(dvec2 c) {
+                    double tolerance = packDouble2x32(u_periodicityTolerance);
                     dvec2 z = dvec2(0.0, 0.0);
+                    dvec2 saved = dvec2(1e30, 1e30);
+                    int checkpoint = 64;
+                    int period = 64;
                     int i;
                     for (i = 0; i < u_maxIterations; i++) {
-                        if (length(z) > 2.0) break;
+                        if (dot(z, z) > 4.0) break;
+                        if (tolerance > 0.0) {
+                            if (dot(z - saved, z - saved) < tolerance * tolerance) return u_maxIterations;
+                            if (i >= checkpoint) {
+                                saved = z;
+                                period *= 2;
+                                checkpoint = i + period;
+                            }
+                        }
                         z = dvec2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + c;
                     }
+                    return i;
+                }
+
+                int iterateDoubleDouble(dvec2 cx, dvec2 cy) {
+                    double tolerance = packDouble2x32(u_periodicityTolerance);
+                    dvec2 zx = dvec2(0.0, 0.0);
+                    dvec2 zy = dvec2(0.0, 0.0);
+                    dvec2 savedX = dvec2(1e30, 0.0);
+                    dvec2 savedY = dvec2(1e30, 0.0);
+                    int checkpoint = 64;
+                    int period = 64;
+                    int i;
+                    for (i = 0; i < u_maxIterations; i++) {
+                        dvec2 zx2 = ddMul(zx, zx);
+                        dvec2 zy2 = ddMul(zy, zy);
+                        if (zx2.x + zy2.x > 4.0) break;
+                        if (tolerance > 0.0) {
+                            dvec2 difference = dvec2(ddAdd(zx, -savedX).x, ddAdd(zy, -savedY).x);
+                            if (dot(difference, difference) < tolerance * tolerance) return u_maxIterations;
+                            if (i >= checkpoint) {
+                                savedX = zx;
+                                savedY = zy;
+                                period *= 2;
+                                checkpoint = i + period;
+                            }
+                        }
+
+                        zy = ddAdd(2.0 * ddMul(zx, zy), cy);
+                        zx = ddAdd(ddAdd(zx2, -zy2), cx);
+                    }
+                    return i;
+                }
+
+                int iteratePerturbation(dvec2 dc) {
+                    dvec2 d = dvec2(0.0, 0.0);
+
+                    // i counts the iterations of the pixel, m is the position on the reference orbit
+                    int i = 0;
+                    int m = 0;
+                    while (i < u_maxIterations) {
+                        uvec4 texel = texelFetch(u_referenceOrbit, m);
+                        dvec2 Z = dvec2(packDouble2x32(texel.xy), packDouble2x32(texel.zw));
+                        dvec2 z = Z + d;
+                        if (dot(z, z) > 4.0) break;
+
+                        // Rebase (see PerturbationKernel): continue relative to Z_0 = 0
+                        if (dot(z, z) < dot(d, d) || m == u_referenceLength - 1) {
+                            d = z;
+                            Z = dvec2(0.0, 0.0);
+                            m = 0;
+                        }
+
+                        // d' = A * d + B * dc, skipping several iterations at once
+                        int step = lookupBla(m, dot(d, d), u_maxIterations - i);
+                        if (step >= 0) {
+                            uvec4 a = texelFetch(u_blaTable, step);
+                            uvec4 b = texelFetch(u_blaTable, step + 1);
+                            dvec2 A = dvec2(packDouble2x32(a.xy), packDouble2x32(a.zw));
+                            dvec2 B = dvec2(packDouble2x32(b.xy), packDouble2x32(b.zw));
+                            d = dvec2(A.x * d.x - A.y * d.y, A.x * d.y + A.y * d.x) +
+                                dvec2(B.x * dc.x - B.y * dc.y, B.x * dc.y + B.y * dc.x);
+
+                            int length = int(packDouble2x32(texelFetch(u_blaTable, step + 2).zw));
+                            i += length;
+                            m += length;
+                            continue;
+                        }
+
+                        // d' = 2 * Z * d + d^2 + dc
+                        d = dvec2(2.0 * (Z.x * d.x - Z.y * d.y) + (d.x * d.x - d.y * d.y),
+                                  2.0 * (Z.x * d.y + Z.y * d.x) + 2.0 * d.x * d.y) + dc;
+                        i++;
+                        m++;
+                    }
+                    return i;
+                }
+
+                void main() {
+                    int guessed = u_guessPass != 0 ? guessIterations() : -1;
+                    if (u_guessPass == 2 && guessed < 0) discard;
+
+                    int i;
+                    if (guessed >= 0) {
+                        i = guessed;
+                    } else if (u_backend == 1) {
+                        // Counts reused from a deeper frame (BaseFractal::requestZoom) may exceed the current limit
+                        i = min(int(texelFetch(u_iterations, ivec2(gl_FragCoord.xy), 0).r), u_maxIterations);
+                    } else if (u_precisionTier == 1) {
+                        dvec2 offset = dvec2(gl_FragCoord.xy - u_resolution / 2.0) * packDouble2x32(u_scale);
+                        dvec2 cx = ddAdd(dvec2(packDouble2x32(u_centerX), packDouble2x32(u_centerXLow)),
+                                         dvec2(offset.x, 0.0));
+                        dvec2 cy = ddAdd(dvec2(packDouble2x32(u_centerY), packDouble2x32(u_centerYLow)),
+                                         dvec2(offset.y, 0.0));
+                        if (u_interiorCheck != 0 && isInMainCardioidOrBulbDoubleDouble(cx, cy)) {
+                            i = u_maxIterations;
+                        } else {
+                            i = iterateDoubleDouble(cx, cy);
+                        }
+                    } else if (u_precisionTier == 2) {
+                        dvec2 offset = dvec2(packDouble2x32(u_referenceOffsetX), packDouble2x32(u_referenceOffsetY));
+                        dvec2 dc = offset + dvec2(gl_FragCoord.xy - u_resolution / 2.0) * packDouble2x32(u_scale);
+                        i = iteratePerturbation(dc);
+                    } else {
+                        dvec2 center = dvec2(packDouble2x32(u_centerX), packDouble2x32(u_centerY));
+                        dvec2 c = center + dvec2(gl_FragCoord.xy - u_resolution / 2.0) * packDouble2x32(u_scale);
+                        if (u_interiorCheck != 0 && isInMainCardioidOrBulb(c)) {
+                            i = u_maxIterations;
+                        } else {
+                            i = iterateDouble(c);
+                        }
+                    }
                     vec3 finalColor = getColor(float(i), float(u_maxIterations));
                     FragColor = vec4(finalColor, 1.0);
+                    FragIterations = uint(i);
                 }
         )";
         }
 
         void setUniforms() override {
-            glUniform2f(glGetUniformLocation(_shaderProgram, "u_resolution"), _width, _height);
-            glUniform2f(glGetUniformLocation(_shaderProgram, "u_center"), _center.first, _center.second);
-            glUniform1f(glGetUniformLocation(_shaderProgram, "u_scale"), _scale / _width);
+            const Viewport viewport = getViewport();
+            // Resolution of the current (possibly coarse) pass
+            const int width = getRenderWidth();
+            const int height = getRenderHeight();
+
+            _resolutionUniform.set({static_cast<float>(width), static_cast<float>(height)});
+            _centerXUniform.set(viewport.center.first);
+            _centerYUniform.set(viewport.center.second);
+            _scaleUniform.set(viewport.getPixelSize(width));
+            _centerXLowUniform.set(viewport.centerLow.first);
+            _centerYLowUniform.set(viewport.centerLow.second);
+            _maxIterationsUniform.set(viewport.maxIterations);
+            _interiorCheckUniform.set(viewport.interiorCheck ? 1 : 0);
+
+            _backendUniform.set(usesIterationTexture() ? 1 : 0);
+            // Samplers of different types must not share a unit, even if unused (Mesa refuses to draw otherwise)
+            _iterationsUniform.set(0);
+            _referenceOrbitUniform.set(1);
+            _blaTableUniform.set(2);
+
+            const PrecisionTier tier = selectPrecisionTier(viewport.getPixelSize(width));
+            _precisionTierUniform.set(static_cast<int>(tier));
+            _periodicityToleranceUniform.set(viewport.periodicityCheck && tier != PrecisionTier::Perturbation
+                                                 ? getPeriodicityTolerance(tier, viewport.getPixelSize(width))
+                                                 : 0.0);
+            if (tier == PrecisionTier::Perturbation && _backend == RenderBackend::GPU) {
+                const std::pair<FloatExp, FloatExp> offset = updateReferenceOrbit(viewport);
+                if (!_referenceUploaded) {
+                    uploadDoubleBuffer(1, _referenceOrbit.getValues());
+
+                    std::vector<int> levelOffsets;
+                    uploadDoubleBuffer(2, _approximation.serialize(levelOffsets));
+                    std::vector<int> levelSizes;
+                    for (int level = 0; level < _approximation.getLevelCount(); level++) {
+                        levelSizes.push_back(static_cast<int>(_approximation.getLevel(level).size()));
+                    }
+
+                    const size_t levels = std::min<size_t>(levelSizes.size(), 24);
+                    levelOffsets.resize(levels);
+                    levelSizes.resize(levels);
+                    _blaLevelsUniform.set(static_cast<int>(levels));
+                    _blaLevelOffsetsUniform.set(levelOffsets);
+                    _blaLevelSizesUniform.set(levelSizes);
+                    _referenceUploaded = true;
+                }
+
+                _referenceLengthUniform.set(_referenceOrbit.getLength());
+                _referenceOffsetXUniform.set(offset.first.toDouble());
+                _referenceOffsetYUniform.set(offset.second.toDouble());
+            }
+        }
+
+        void computeIterations(IterationBuffer& p_buffer, const std::vector<Tile>& p_regions) override {
+            const Viewport viewport = getViewport();
+            _kernel.resetStatistics();
+            _doubleDoubleKernel.resetStatistics();
+            getCpuRenderer().resetStatistics();
+
+            if (_exponentialMap) {
+                _exponentialMap->renderFrame(viewport.getExtendedPixelSize(p_buffer.getWidth()),
+                                             viewport.maxIterations,
+                                             p_buffer,
+                                             p_regions,
+                                             getCpuRenderer().getScheduler());
+                _statistics = {};
+                return;
+            }
+
+            if (_tileCacheEnabled && TileCache::levelFor(viewport.getPixelSize(p_buffer.getWidth())) >= 0) {
+                _tileCache.render(viewport,
+                                  getCpuRenderer(),
+                                  [this](const Viewport& p_tile) -> IEscapeTimeKernel& {
+                                      if (selectPrecisionTier(p_tile.getPixelSize(TileCache::TILE_SIZE)) ==
+                                          PrecisionTier::Double) {
+                                          return _kernel;
+                                      }
+                                      return _doubleDoubleKernel;
+                                  },
+                                  p_buffer,
+                                  p_regions);
+                _statistics = {};
+                return;
+            }
 
+            switch (selectPrecisionTier(viewport.getPixelSize(p_buffer.getWidth()))) {
+                case PrecisionTier::Double:
+                    getCpuRenderer().render(viewport, _kernel, p_buffer, p_regions);
+                    _statistics = {};
+                    break;
+                case PrecisionTier::DoubleDouble:
+                    getCpuRenderer().render(viewport, _doubleDoubleKernel, p_buffer, p_regions);
+                    _statistics = {};
+                    break;
+                case PrecisionTier::Perturbation:
+                    _perturbationKernel.setReference(&_referenceOrbit, updateReferenceOrbit(viewport), &_approximation);
+                    _perturbationKernel.resetStatistics();
+                    getCpuRenderer().render(viewport, _perturbationKernel, p_buffer, p_regions);
+                    _statistics = _perturbationKernel.getStatistics();
+                    break;
+            }
+        }
+
+        // Hits are nearest samples of the cached level, which may be up to twice as fine as the frame's pixels
+        bool lookupIterations(IterationBuffer& p_buffer, const std::vector<Tile>& p_regions) override {
+            return _tileCacheEnabled && _tileCache.lookup(getViewport(), p_buffer, p_regions);
+        }
+
+        /**
+         * Recompute the reference orbit, if the current one can't be used for the viewport anymore.
+         *
+         * @return The viewport center minus the reference point.
+         */
+        std::pair<FloatExp, FloatExp> updateReferenceOrbit(const Viewport& p_viewport) {
+            const FixedPoint& referenceReal = _referenceOrbit.getCenterReal();
+            const FixedPoint& referenceImaginary = _referenceOrbit.getCenterImaginary();
+            std::pair<FloatExp, FloatExp> offset = {(_center.first - referenceReal).toFloatExp(),
+                                                    (_center.second - referenceImaginary).toFloatExp()};
+
+            // Panning keeps the reference as long as it stays close to the view, the offset is just applied to dc
+            const bool empty = _referenceOrbit.getLength() == 0;
+            const bool tooFar = std::max(offset.first.abs(), offset.second.abs()) > p_viewport.scale;
+            // An escaped reference is fine (pixels rebase), a too short one would just rebase more often than needed
+            const bool tooShort = !_referenceOrbit.hasEscaped() &&
+                                  _referenceOrbit.getMaxIterations() < p_viewport.maxIterations;
+            const bool tooImprecise = referenceReal.getFractionLimbs() < _center.first.getFractionLimbs();
+
+            if (empty || tooFar || tooShort || tooImprecise) {
+                _referenceOrbit.compute(_center.first, _center.second, p_viewport.maxIterations);
+                _referenceUploaded = false;
+                offset = {};
+            }
+
+            // Largest |dc| of the frame: offset plus half of the diagonal (the BLA radii depend on it). Beyond the
+            // double range it underflows to 0, the radii are then limited by |Z| alone, dc is negligible anyway.
+            const double maxDeltaC = std::hypot(offset.first.toDouble(), offset.second.toDouble()) +
+                                     0.5 * p_viewport.scale.toDouble() * std::hypot(1.0, _height / _width);
+            // Zooming in keeps the reference for a long time, the radii built for the old |dc| would block longer
+            // steps, so the table follows shrinking frames as well
+            if (!_referenceUploaded || maxDeltaC > _approximation.getMaxDeltaC() ||
+                maxDeltaC * APPROXIMATION_RANGE < _approximation.getMaxDeltaC()) {
+                // Some headroom, so small pans don't rebuild the table every frame
+                _approximation.compute(_referenceOrbit, 2.0 * maxDeltaC);
+                _referenceUploaded = false;
+            }
+            return offset;
+        }
+
+        /**
+         * The viewport state shared by the GPU and the CPU backend.
+         */
+        Viewport getViewport() const {
             // Dynamic iteration count based on zoom level with a cap
-            int dynamicIterations = static_cast<int>(300 + 50 * sqrt(log(10.0f / _scale)));
+            // Views wider than 10 (e.g. from --view) get the minimum, the square root must not see a negative number
+            const double depth = std::max(0.0, log(10.0) - _scale.log());
+            int dynamicIterations = static_cast<int>(300 + 50 * sqrt(depth));
             dynamicIterations = std::min(dynamicIterations, _iterations);  // Cap the iterations to 1000
-            glUniform1i(glGetUniformLocation(_shaderProgram, "u_maxIterations"), dynamicIterations);
+
+            const DoubleDouble centerReal = DoubleDouble::fromFixedPoint(_center.first);
+            const DoubleDouble centerImaginary = DoubleDouble::fromFixedPoint(_center.second);
+            return {{centerReal.high, centerImaginary.high},
+                    _scale,
+                    dynamicIterations,
+                    {centerReal.low, centerImaginary.low},
+                    _interiorCheck,
+                    _periodicityCheck};
         }
 
         void doOnRenderStart() override {
+            // Switch between GPU and CPU backend (B)
+            const bool backendKeyPressed = glfwGetKey(_window, GLFW_KEY_B) == GLFW_PRESS;
+            if (backendKeyPressed && !_backendKeyWasPressed) {
+                setBackend(_backend == RenderBackend::GPU ? RenderBackend::CPU : RenderBackend::GPU);
+                std::cout << "Backend: " << (_backend == RenderBackend::GPU ? "GPU" : "CPU") << " ("
+                          << getSimdLevelName(_kernel.getLevel()) << ")" << std::endl;
+            }
+            _backendKeyWasPressed = backendKeyPressed;
+
+            // Toggle the tile cache (C)
+            const bool cacheKeyPressed = glfwGetKey(_window, GLFW_KEY_C) == GLFW_PRESS;
+            if (cacheKeyPressed && !_cacheKeyWasPressed) {
+                _tileCacheEnabled = !_tileCacheEnabled;
+                _tileCache.resetStatistics();
+                requestRedraw();
+                std::cout << "Tile cache: " << (_tileCacheEnabled ? "on" : "off") << std::endl;
+            }
+            _cacheKeyWasPressed = cacheKeyPressed;
+
+            // Toggle the analytic cardioid/bulb test (I), for comparing frame times with and without it
+            const bool interiorKeyPressed = glfwGetKey(_window, GLFW_KEY_I) == GLFW_PRESS;
+            if (interiorKeyPressed && !_interiorKeyWasPressed) {
+                setInteriorCheck(!_interiorCheck);
+                std::cout << "Interior check: " << (_interiorCheck ? "on" : "off") << std::endl;
+            }
+            _interiorKeyWasPressed = interiorKeyPressed;
+
+            // Toggle the solid guessing of the GPU backend (G)
+            const bool guessKeyPressed = glfwGetKey(_window, GLFW_KEY_G) == GLFW_PRESS;
+            if (guessKeyPressed && !_guessKeyWasPressed) {
+                setSolidGuessing(!getSolidGuessing());
+                std::cout << "Solid guessing: " << (getSolidGuessing() ? "on" : "off") << std::endl;
+            }
+            _guessKeyWasPressed = guessKeyPressed;
+
+            // Cycle the subdivision of the CPU backend (M): off, interior, uniform
+            const bool subdivisionKeyPressed = glfwGetKey(_window, GLFW_KEY_M) == GLFW_PRESS;
+            if (subdivisionKeyPressed && !_subdivisionKeyWasPressed) {
+                switch (getCpuRenderer().getSubdivision()) {
+                    case Subdivision::Off: setSubdivision(Subdivision::Interior); break;
+                    case Subdivision::Interior: setSubdivision(Subdivision::Uniform); break;
+                    case Subdivision::Uniform: setSubdivision(Subdivision::Off); break;
+                }
+                std::cout << "Subdivision: " << getSubdivisionName(getCpuRenderer().getSubdivision()) << std::endl;
+            }
+            _subdivisionKeyWasPressed = subdivisionKeyPressed;
+
+            // Save the view at full resolution as PNG (P), as PPM with shift held
+            const bool saveKeyPressed = glfwGetKey(_window, GLFW_KEY_P) == GLFW_PRESS;
+            if (saveKeyPressed && !_saveKeyWasPressed) {
+                const bool ppm = glfwGetKey(_window, GLFW_KEY_LEFT_SHIFT) == GLFW_PRESS ||
+                                 glfwGetKey(_window, GLFW_KEY_RIGHT_SHIFT) == GLFW_PRESS;
+                const std::time_t now = std::time(nullptr);
+                std::ostringstream path;
+                path << "Mandelbrot_" << std::put_time(std::localtime(&now), "%Y%m%d_%H%M%S")
+                     << (ppm ? ".ppm" : ".png");
+                try {
+                    saveFrame(path.str(), captureFrame());
+                    std::cout << "Saved " << path.str() << std::endl;
+                } catch (const std::exception& p_error) { std::cout << p_error.what() << std::endl; }
+            }
+            _saveKeyWasPressed = saveKeyPressed;
+
             // print scale and location
             if (glfwGetKey(_window, GLFW_KEY_L) == GLFW_PRESS) {
                 std::cout << std::endl;
-                std::cout << "X val: " << std::setprecision(8) << _center.first << std::endl;
-                std::cout << "Y val: " << std::setprecision(8) << _center.second << std::endl;
-                std::cout << "Scale: " << _scale << std::endl;
+                // Enough digits to tell neighbouring pixels apart
+                const int digits = std::max(8, static_cast<int>(-(_scale / _width).log() / std::log(10.0)) + 3);
+                std::cout << "X val: " << _center.first.toString(digits) << std::endl;
+                std::cout << "Y val: " << _center.second.toString(digits) << std::endl;
+                std::cout << "Scale: " << _scale.toString() << std::endl;
+                const bool perturbation =
+                    selectPrecisionTier((_scale / _width).toDouble()) == PrecisionTier::Perturbation;
+                if (_backend == RenderBackend::CPU && perturbation) {
+                    std::cout << "Iterations skipped by BLA: " << _statistics.skippedIterations << std::endl;
+                    std::cout << "Rebases: " << _statistics.rebases << std::endl;
+                }
+                if (_backend == RenderBackend::CPU && !perturbation) {
+                    std::cout << "Pixels stopped by periodicity: " << getPeriodicPixels() << std::endl;
+                }
+                if (_backend == RenderBackend::GPU && getSolidGuessing()) {
+                    std::cout << "Pixels guessed: " << 100.0 * getGuessedFraction() << " %" << std::endl;
+                }
+                if (_backend == RenderBackend::CPU && getCpuRenderer().getSubdivision() != Subdivision::Off) {
+                    std::cout << "Pixels filled by subdivision: " << getCpuRenderer().getFilledPixels() << std::endl;
+                }
+                if (_tileCacheEnabled) {
+                    std::cout << "Cached tiles: " << _tileCache.getHits() << " hits, " << _tileCache.getStoreHits()
+                              << " read from disk, " << _tileCache.getMisses() << " misses, "
+                              << (_tileCache.getMemoryUsage() >> 20) << " MiB" << std::endl;
+                }
             }
 
-            // Zoom (W/S)
-            if (glfwGetKey(_window, GLFW_KEY_W) == GLFW_PRESS) { _scale *= 0.95; }
-            if (glfwGetKey(_window, GLFW_KEY_S) == GLFW_PRESS && _scale < 8.0) { _scale /= 0.9; }
+            // Zoom (W/S), zoom out 3x (E, reuses a third of the last frame on the CPU backend)
+            double zoomFactor = 1.0;
+            if (glfwGetKey(_window, GLFW_KEY_W) == GLFW_PRESS) {
+                _scale *= 0.95;
+                zoomFactor *= 0.95;
+            }
+            if (glfwGetKey(_window, GLFW_KEY_S) == GLFW_PRESS && _scale < 8.0) {
+                _scale /= 0.9;
+                zoomFactor /= 0.9;
+            }
+            const bool zoomOutKeyPressed = glfwGetKey(_window, GLFW_KEY_E) == GLFW_PRESS;
+            // Same limit as S, the result must stay below it
+            if (zoomOutKeyPressed && !_zoomOutKeyWasPressed && _scale * 3.0 < 8.0) {
+                _scale *= 3.0;
+                zoomFactor *= 3.0;
+            }
+            _zoomOutKeyWasPressed = zoomOutKeyPressed;
+
+            // The shader only has doubles for the perturbation deltas
+            if (_backend == RenderBackend::GPU &&
+                (_scale / _width).exponent < PerturbationKernel::minDoubleExponent) {
+                setBackend(RenderBackend::CPU);
+                std::cout << "Beyond the double range, switching to the CPU backend" << std::endl;
+            }
+
+            // The center needs more bits the deeper we zoom
+            const int fractionLimbs = FixedPoint::fractionLimbsFor(_scale / _width);
+            _center.first.setFractionLimbs(fractionLimbs);
+            _center.second.setFractionLimbs(fractionLimbs);
+
+            // Move (Arrow Keys) by whole pixels (~0.5% of the width), so the last frame can be shifted and reused
+            const int movePixels = std::max(1, static_cast<int>(0.005 * _width));
+            const FixedPoint moveAmount(_scale / _width * movePixels, fractionLimbs);
+            int panX = 0;
+            int panY = 0;
+            if (glfwGetKey(_window, GLFW_KEY_UP) == GLFW_PRESS) {
+                _center.second += moveAmount;
+                panY += movePixels;
+            }
+            if (glfwGetKey(_window, GLFW_KEY_DOWN) == GLFW_PRESS) {
+                _center.second -= moveAmount;
+                panY -= movePixels;
+            }
+            if (glfwGetKey(_window, GLFW_KEY_LEFT) == GLFW_PRESS) {
+                _center.first -= moveAmount;
+                panX -= movePixels;
+            }
+            if (glfwGetKey(_window, GLFW_KEY_RIGHT) == GLFW_PRESS) {
+                _center.first += moveAmount;
+                panX += movePixels;
+            }
 
-            // Move (Arrow Keys)
-            double moveAmount = 0.005f * _scale;
-            if (glfwGetKey(_window, GLFW_KEY_UP) == GLFW_PRESS) { _center.second += moveAmount; }
-            if (glfwGetKey(_window, GLFW_KEY_DOWN) == GLFW_PRESS) { _center.second -= moveAmount; }
-            if (glfwGetKey(_window, GLFW_KEY_LEFT) == GLFW_PRESS) { _center.first -= moveAmount; }
-            if (glfwGetKey(_window, GLFW_KEY_RIGHT) == GLFW_PRESS) { _center.first += moveAmount; }
+            const bool panned = panX != 0 || panY != 0;
+            if (zoomFactor != 1.0 && panned) {
+                requestRedraw();
+            } else if (zoomFactor != 1.0) {
+                requestZoom(zoomFactor);
+            } else if (panned) {
+                requestPan(panX, panY);
+            }
         }
 
         void doOnRenderEnd() {}
 
+        /**
+         * Show another part of the plane.
+         *
+         * @param p_scale Visible width.
+         */
+        void setView(double p_real, double p_imaginary, double p_scale) {
+            _scale = p_scale;
+            const int fractionLimbs = FixedPoint::fractionLimbsFor(_scale / _width);
+            _center = {FixedPoint(p_real, fractionLimbs), FixedPoint(p_imaginary, fractionLimbs)};
+            requestRedraw();
+        }
+
+        /**
+         * Enable or disable the analytic test for the main cardioid and the period-2 bulb in all kernels (see
+         * Viewport::interiorCheck). The images are the same either way, only the time to render the interior changes.
+         */
+        void setInteriorCheck(bool p_enabled) {
+            _interiorCheck = p_enabled;
+            requestRedraw();
+        }
+
+        /**
+         * Enable or disable the periodicity detection of the double and double-double tiers (see
+         * Viewport::periodicityCheck).
+         */
+        void setPeriodicityCheck(bool p_enabled) {
+            _periodicityCheck = p_enabled;
+            requestRedraw();
+        }
+
+        /**
+         * Select the rectangles, which the CPU backend fills instead of computing them (see Subdivision).
+         */
+        void setSubdivision(Subdivision p_subdivision) {
+            getCpuRenderer().setSubdivision(p_subdivision);
+            requestRedraw();
+        }
+
+        static const char* getSubdivisionName(Subdivision p_subdivision) {
+            switch (p_subdivision) {
+                case Subdivision::Interior: return "interior";
+                case Subdivision::Uniform: return "uniform";
+                default: return "off";
+            }
+        }
+
+        /**
+         * @return Pixels of the last frame computed by the CPU backend, which were stopped by the periodicity
+         * detection (the shader can't count them).
+         */
+        uint64_t getPeriodicPixels() const {
+            return _kernel.getPeriodicPixels() + _doubleDoubleKernel.getPeriodicPixels();
+        }
+
+        /**
+         * @return Pixels of the last frame computed by the CPU backend, which were filled by the subdivision.
+         */
+        uint64_t getFilledPixels() { return getCpuRenderer().getFilledPixels(); }
+
+        /**
+         * Save a frame (see captureFrame) as PNG or binary PPM, depending on the extension. PNGs are compressed on the
+         * worker threads of the CPU backend.
+         *
+         * @throws ImageWriteError, if the file can't be written.
+         */
+        void saveFrame(const std::string& p_path, const Image& p_image) {
+            saveImage(p_path, p_image, getCpuRenderer().getScheduler());
+        }
+
+        /**
+         * Render the current view as a poster of p_width x p_height pixels (PNG or binary PPM). It's rendered in tiles
+         * of the offscreen target size with the selected backend, one band of tiles at a time, so the memory only
+         * grows with the poster width. Views too deep for the GPU are exported on the CPU, the backend is switched
+         * back afterwards. An interrupted export of the same view resumes (see PosterFile), PNGs are compressed band by
+         * band and always start over.
+         *
+         * @throws ImageWriteError, if the file can't be written.
+         */
+        void exportPoster(const std::string& p_path, int p_width, int p_height) {
+            const FloatExp pixelSize = _scale / FloatExp(p_width);
+            const int tileWidth = static_cast<int>(_width);
+            const int tileHeight = static_cast<int>(_height);
+            const int fractionLimbs = FixedPoint::fractionLimbsFor(pixelSize);
+            const RenderBackend backend = _backend;
+            if (_backend == RenderBackend::GPU && pixelSize.exponent < PerturbationKernel::minDoubleExponent) {
+                setBackend(RenderBackend::CPU);
+            }
+
+            const int digits = std::max(8, static_cast<int>(-pixelSize.log() / std::log(10.0)) + 3);
+            std::ostringstream job;
+            job << p_width << "x" << p_height << " tiles " << tileWidth << "x" << tileHeight << " center "
+                << _center.first.toString(digits) << " " << _center.second.toString(digits) << " scale "
+                << _scale.toString() << " iterations " << _iterations << " backend "
+                << (_backend == RenderBackend::GPU ? "GPU" : "CPU");
+            std::unique_ptr<IImageWriter> file;
+            int completedRows = 0;
+            if (isPngPath(p_path)) {
+                file = createImageWriter(p_path, p_width, p_height, getCpuRenderer().getScheduler());
+            } else {
+                auto poster = std::make_unique<PosterFile>(p_path, p_width, p_height, job.str());
+                completedRows = poster->getCompletedRows();
+                file = std::move(poster);
+            }
+
+            const std::pair<FixedPoint, FixedPoint> center = _center;
+            const FloatExp scale = _scale;
+            _scale = pixelSize * FloatExp(tileWidth);
+
+            std::vector<uint8_t> band;
+            for (int top = completedRows; top < p_height; top += tileHeight) {
+                const int rows = std::min(tileHeight, p_height - top);
+                band.resize(static_cast<size_t>(rows) * p_width * 3);
+
+                for (int left = 0; left < p_width; left += tileWidth) {
+                    // Tile center relative to the poster center in pixels, the imaginary axis points up
+                    const double offsetX = left + tileWidth / 2.0 - p_width / 2.0;
+                    const double offsetY = p_height / 2.0 - (top + tileHeight / 2.0);
+                    _center = {center.first + FixedPoint(pixelSize * FloatExp(offsetX), fractionLimbs),
+                               center.second + FixedPoint(pixelSize * FloatExp(offsetY), fractionLimbs)};
+                    _center.first.setFractionLimbs(fractionLimbs);
+                    _center.second.setFractionLimbs(fractionLimbs);
+
+                    const Image image = captureFrame();
+                    const int columns = std::min(tileWidth, p_width - left);
+                    for (int row = 0; row < rows; row++) {
+                        std::memcpy(&band[(static_cast<size_t>(row) * p_width + left) * 3],
+                                    &image.pixels[static_cast<size_t>(row) * image.width * 3],
+                                    static_cast<size_t>(columns) * 3);
+                    }
+                }
+
+                file->writeRows(band.data(), rows);
+                std::cout << "Poster: " << top + rows << " / " << p_height << " rows" << std::endl;
+            }
+            file->finish();
+
+            setBackend(backend);
+            _center = center;
+            _scale = scale;
+            requestRedraw();
+        }
+
+        /**
+         * Render a zoom animation, every frame of p_keyframes at full resolution with the selected backend. While a
+         * frame renders, the previous ones are encoded and written (see FramePipeline). Progress goes to stderr, as
+         * stdout may carry the video.
+         *
+         * @param p_output See FramePipeline.
+         * @param p_exponentialMap Resample the frames from an ExponentialMap of the zoom center on the CPU, instead of
+         *                         rendering each one. Only for keyframes with a single center.
+         *
+         * @throws ImageWriteError, if the output can't be written.
+         */
+        void renderAnimation(const KeyframeTrack& p_keyframes,
+                             const std::string& p_output,
+                             int p_framesPerSecond,
+                             bool p_exponentialMap = false) {
+            FramePipeline pipeline(p_output, static_cast<int>(_width), static_cast<int>(_height), p_framesPerSecond);
+            const std::pair<FixedPoint, FixedPoint> center = _center;
+            const FloatExp scale = _scale;
+            const int iterations = _iterations;
+            const RenderBackend backend = _backend;
+
+            if (p_exponentialMap && !p_keyframes.hasFixedCenter()) {
+                std::cerr << "The keyframes move the center, rendering every frame instead of an exponential map"
+                          << std::endl;
+            } else if (p_exponentialMap) {
+                createExponentialMap(p_keyframes);
+                setBackend(RenderBackend::CPU);
+            }
+
+            const int frameCount = p_keyframes.getFrameCount();
+            for (int frame = 0; frame < frameCount; frame++) {
+                const Keyframe keyframe = p_keyframes.at(frame);
+                _scale = keyframe.scale;
+                _iterations = keyframe.maxIterations;
+                const int fractionLimbs = FixedPoint::fractionLimbsFor(_scale / _width);
+                _center = {keyframe.real, keyframe.imaginary};
+                _center.first.setFractionLimbs(fractionLimbs);
+                _center.second.setFractionLimbs(fractionLimbs);
+                if (_backend == RenderBackend::GPU &&
+                    (_scale / _width).exponent < PerturbationKernel::minDoubleExponent) {
+                    setBackend(RenderBackend::CPU);
+                    std::cerr << "Beyond the double range, switching to the CPU backend" << std::endl;
+                }
+
+                pipeline.push(captureFrame());
+                std::cerr << "Animation: " << frame + 1 << " / " << frameCount << " frames" << std::endl;
+            }
+            pipeline.finish();
+
+            if (_exponentialMap) {
+                const double pixels = static_cast<double>(frameCount) * _width * _height;
+                std::cerr << "Exponential map: " << _exponentialMap->getComputedSamples() << " samples for "
+                          << pixels << " pixels" << std::endl;
+                _exponentialMap.reset();
+            }
+            setBackend(backend);
+            _center = center;
+            _scale = scale;
+            _iterations = iterations;
+        }
+
+        /**
+         * Exponential map around the (fixed) center of p_keyframes, deep and detailed enough for all frames.
+         */
+        void createExponentialMap(const KeyframeTrack& p_keyframes) {
+            // Deepest scale and highest iteration limit of all frames (the limit grows with the zoom depth)
+            FloatExp minScale = p_keyframes.at(0).scale;
+            int maxIterations = 0;
+            for (int frame = 0; frame < p_keyframes.getFrameCount(); frame++) {
+                const Keyframe keyframe = p_keyframes.at(frame);
+                _scale = keyframe.scale;
+                _iterations = keyframe.maxIterations;
+                if (keyframe.scale < minScale) minScale = keyframe.scale;
+                maxIterations = std::max(maxIterations, getViewport().maxIterations);
+            }
+
+            const Keyframe first = p_keyframes.at(0);
+            const int fractionLimbs = FixedPoint::fractionLimbsFor(minScale / _width);
+            FixedPoint real = first.real;
+            FixedPoint imaginary = first.imaginary;
+            real.setFractionLimbs(fractionLimbs);
+            imaginary.setFractionLimbs(fractionLimbs);
+            const FloatExp anchor = first.scale / _width * FloatExp(std::hypot(_width / 2.0, _height / 2.0));
+            const int angles = ExponentialMap::getAnglesFor(static_cast<int>(_width), static_cast<int>(_height));
+            _exponentialMap = std::make_unique<ExponentialMap>(real, imaginary, anchor, angles, maxIterations);
+        }
+
+        /**
+         * Keep computed tiles in p_directory across sessions (see TileStore), enables the tile cache.
+         *
+         * @throws TileStoreError, if the store can't be opened.
+         */
+        void openTileStore(const std::string& p_directory) {
+            _tileCache.openStore(p_directory);
+            _tileCacheEnabled = true;
+        }
+
     private:
-        double _scale = 10.0f;
+        // Uniforms of the fragment shader, resolved once after linking
+        Uniform<std::array<float, 2>> _resolutionUniform{_uniforms, "u_resolution"};
+        Uniform<double> _centerXUniform{_uniforms, "u_centerX"};
+        Uniform<double> _centerYUniform{_uniforms, "u_centerY"};
+        Uniform<double> _scaleUniform{_uniforms, "u_scale"};
+        Uniform<double> _centerXLowUniform{_uniforms, "u_centerXLow"};
+        Uniform<double> _centerYLowUniform{_uniforms, "u_centerYLow"};
+        Uniform<int> _maxIterationsUniform{_uniforms, "u_maxIterations"};
+        Uniform<int> _interiorCheckUniform{_uniforms, "u_interiorCheck"};
+        Uniform<double> _periodicityToleranceUniform{_uniforms, "u_periodicityTolerance"};
+        Uniform<int> _backendUniform{_uniforms, "u_backend"};
+        Uniform<int> _iterationsUniform{_uniforms, "u_iterations"};
+        Uniform<int> _precisionTierUniform{_uniforms, "u_precisionTier"};
+        Uniform<int> _referenceOrbitUniform{_uniforms, "u_referenceOrbit"};
+        Uniform<int> _referenceLengthUniform{_uniforms, "u_referenceLength"};
+        Uniform<double> _referenceOffsetXUniform{_uniforms, "u_referenceOffsetX"};
+        Uniform<double> _referenceOffsetYUniform{_uniforms, "u_referenceOffsetY"};
+        Uniform<int> _blaTableUniform{_uniforms, "u_blaTable"};
+        Uniform<int> _blaLevelsUniform{_uniforms, "u_blaLevels"};
+        Uniform<std::vector<int>> _blaLevelOffsetsUniform{_uniforms, "u_blaLevelOffsets"};
+        Uniform<std::vector<int>> _blaLevelSizesUniform{_uniforms, "u_blaLevelSizes"};
+
+        // The BLA table is rebuilt once the frame's |dc| shrank by this factor (see updateReferenceOrbit)
+        static constexpr double APPROXIMATION_RANGE = 16.0;
+
+        SimdMandelbrotKernel _kernel;
+        DoubleDoubleKernel _doubleDoubleKernel;
+        bool _backendKeyWasPressed = false;
+        bool _zoomOutKeyWasPressed = false;
+        bool _interiorCheck = true;
+        bool _interiorKeyWasPressed = false;
+        bool _periodicityCheck = true;
+        bool _subdivisionKeyWasPressed = false;
+        bool _guessKeyWasPressed = false;
+
+        // Iteration counts of visited areas (see TileCache), used by both backends
+        TileCache _tileCache;
+        bool _tileCacheEnabled = false;
+        bool _cacheKeyWasPressed = false;
+        bool _saveKeyWasPressed = false;
+
+        // Zoom animations resample their frames from it (see renderAnimation)
+        std::unique_ptr<ExponentialMap> _exponentialMap;
+
+        // Deep zoom
+        ReferenceOrbit _referenceOrbit;
+        BilinearApproximation _approximation;
+        PerturbationKernel _perturbationKernel;
+        bool _referenceUploaded = false;
+        PerturbationStatistics _statistics;
+
+        // Extended exponent, zooms beyond ~1e-308 are possible on the CPU backend
+        FloatExp _scale = 10.0f;
         int _iterations = 1000;
-        // Up to 8 digits precision
-        std::pair<double, double> _center = {-0.745428, 0.11301201};
-        // std::pair<double, double> _center = {-1.74997970, 0};
-        // std::pair<double, double> _center = {-0.76039999, 0.08277177};
-        // std::pair<double, double> _center = {-0.74999879, 0.0071817112};
-        // std::pair<double, double> _center = {0.19981936, 0.55382456};
-        // std::pair<double, double> _center = {-0.85973844, 0.23495194};
-        // std::pair<double, double> _center = {-0.73885270, 0.14167642};
-        // std::pair<double, double> _center = {-1.4013633, 7.6094599e-05};
-        // std::pair<double, double> _center = {0.26055793, 0.0017685117};
+        // Arbitrary precision, grows with the zoom depth
+        std::pair<FixedPoint, FixedPoint> _center = {FixedPoint(-0.745428, 2), FixedPoint(0.11301201, 2)};
+        // {-1.74997970, 0}
+        // {-0.76039999, 0.08277177}
+        // {-0.74999879, 0.0071817112}
+        // {0.19981936, 0.55382456}
+        // {-0.85973844, 0.23495194}
+        // {-0.73885270, 0.14167642}
+        // {-1.4013633, 7.6094599e-05}
+        // {0.26055793, 0.0017685117}
 };
 
-int main() {
+int main(int argc, char** argv) {
     Mandelbrot mandelbrot;
+
+    // --cpu: start with the CPU backend (toggle at runtime with B)
+    // --tile-store <directory>: persist the tile cache (toggle at runtime with C)
+    // --headless: render a single frame offscreen, without a window
+    // --no-interior-check: iterate the main cardioid and the period-2 bulb as well (toggle at runtime with I)
+    // --no-periodicity-check: iterate interior pixels up to the limit instead of stopping at an attracting cycle
+    // --subdivide <interior|uniform>: fill rectangles with a uniform border on the CPU backend (cycle with M)
+    // --solid-guessing: guess uniform areas from coarse iteration levels on the GPU backend (toggle at runtime with G)
+    // --view <real> <imaginary> <scale>: initial view
+    // --poster <width> <height> <file.ppm|file.png>: export the view as a poster and exit (resumes an interrupted PPM)
+    // --output <file.ppm|file.png>: save the frame rendered with --headless
+    // --animate <keyframes.txt> <output>: render a zoom animation and exit (see KeyframeTrack and FramePipeline)
+    // --fps <frames>: frame rate of an animated .y4m stream (default 30)
+    // --exp-map: resample the animation from one exponential map of the zoom center instead of rendering every frame
+    bool headless = false;
+    const char* keyframePath = nullptr;
+    const char* animationPath = nullptr;
+    int framesPerSecond = 30;
+    bool exponentialMap = false;
+    const char* outputPath = nullptr;
+    const char* posterPath = nullptr;
+    int posterWidth = 0;
+    int posterHeight = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--cpu") == 0) { mandelbrot.setBackend(RenderBackend::CPU); }
+        if (std::strcmp(argv[i], "--tile-store") == 0 && i + 1 < argc) { mandelbrot.openTileStore(argv[++i]); }
+        if (std::strcmp(argv[i], "--headless") == 0) { headless = true; }
+        if (std::strcmp(argv[i], "--no-interior-check") == 0) { mandelbrot.setInteriorCheck(false); }
+        if (std::strcmp(argv[i], "--no-periodicity-check") == 0) { mandelbrot.setPeriodicityCheck(false); }
+        if (std::strcmp(argv[i], "--subdivide") == 0 && i + 1 < argc) {
+            i++;
+            if (std::strcmp(argv[i], "interior") == 0) mandelbrot.setSubdivision(Subdivision::Interior);
+            if (std::strcmp(argv[i], "uniform") == 0) mandelbrot.setSubdivision(Subdivision::Uniform);
+        }
+        if (std::strcmp(argv[i], "--solid-guessing") == 0) { mandelbrot.setSolidGuessing(true); }
+        if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) { outputPath = argv[++i]; }
+        if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc) { framesPerSecond = std::atoi(argv[++i]); }
+        if (std::strcmp(argv[i], "--exp-map") == 0) { exponentialMap = true; }
+        if (std::strcmp(argv[i], "--animate") == 0 && i + 2 < argc) {
+            keyframePath = argv[i + 1];
+            animationPath = argv[i + 2];
+            i += 2;
+        }
+        if (std::strcmp(argv[i], "--view") == 0 && i + 3 < argc) {
+            mandelbrot.setView(std::atof(argv[i + 1]), std::atof(argv[i + 2]), std::atof(argv[i + 3]));
+            i += 3;
+        }
+        if (std::strcmp(argv[i], "--poster") == 0 && i + 3 < argc) {
+            posterWidth = std::atoi(argv[i + 1]);
+            posterHeight = std::atoi(argv[i + 2]);
+            posterPath = argv[i + 3];
+            i += 3;
+        }
+    }
+    mandelbrot.setHeadless(headless);
+
     mandelbrot.initializeWindow("Mandelbrot");
     mandelbrot.createShaderProgram();
     mandelbrot.setupBuffers();
+
+    if (keyframePath) {
+        mandelbrot.renderAnimation(KeyframeTrack(keyframePath), animationPath, framesPerSecond, exponentialMap);
+        return 0;
+    }
+    if (posterPath) {
+        mandelbrot.exportPoster(posterPath, posterWidth, posterHeight);
+        return 0;
+    }
+    if (headless) {
+        std::cout << "Renderer: " << glGetString(GL_RENDERER) << std::endl;
+        const auto start = std::chrono::steady_clock::now();
+        mandelbrot.doOnRenderStart();
+        const Image image = mandelbrot.captureFrame();
+        const std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+        std::cout << "Rendered " << image.width << "x" << image.height << " in " << time.count() << " ms"
+                  << std::endl;
+        if (mandelbrot.getBackend() == RenderBackend::CPU) {
+            std::cout << "Pixels stopped by periodicity: " << mandelbrot.getPeriodicPixels() << std::endl;
+            std::cout << "Pixels filled by subdivision: " << mandelbrot.getFilledPixels() << std::endl;
+        } else if (mandelbrot.getSolidGuessing()) {
+            std::cout << "Pixels guessed: " << 100.0 * mandelbrot.getGuessedFraction() << " %" << std::endl;
+        }
+        if (outputPath) {
+            const auto saveStart = std::chrono::steady_clock::now();
+            mandelbrot.saveFrame(outputPath, image);
+            const std::chrono::duration<double, std::milli> saveTime = std::chrono::steady_clock::now() - saveStart;
+            std::cout << "Saved " << outputPath << " in " << saveTime.count() << " ms" << std::endl;
+        }
+        return 0;
+    }
     mandelbrot.renderFractal();
 }
@@ -0,0 +1,227 @@
+#include <animation/FramePipeline.hpp>
+#include <exception/ImageWriteError.hpp>
+#include <image/IImageWriter.hpp>
+#include <image/PngWriter.hpp>
+#include <image/PpmWriter.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace {
+    // Rows per task of the color conversion, even so the chroma rows aren't split
+    constexpr int CONVERSION_ROWS = 16;
+
+    inline uint8_t toByte(double p_value) { return static_cast<uint8_t>(std::clamp(p_value + 0.5, 0.0, 255.0)); }
+}
+
+FramePipeline::FramePipeline(const std::string& p_output, int p_width, int p_height, int p_framesPerSecond)
+    : _output(p_output),
+      _video(p_output == "-" || (p_output.size() >= 4 && p_output.compare(p_output.size() - 4, 4, ".y4m") == 0)),
+      _width(p_width),
+      _height(p_height),
+      // Half of the cores, the other half renders
+      _scheduler(std::max(1u, std::thread::hardware_concurrency() / 2)) {
+    if (_video) {
+        if (p_output == "-") {
+            _stream = &std::cout;
+        } else {
+            _file.open(p_output, std::ios::binary | std::ios::trunc);
+            if (!_file) throw ImageWriteError(p_output, "can't be created");
+            _stream = &_file;
+        }
+        *_stream << "YUV4MPEG2 W" << p_width << " H" << p_height << " F" << p_framesPerSecond
+                 << ":1 Ip A1:1 C420jpeg\n";
+    } else {
+        parseFramePattern();
+    }
+
+    _encoder = std::thread(&FramePipeline::encodeLoop, this);
+    _writer = std::thread(&FramePipeline::writeLoop, this);
+}
+
+FramePipeline::~FramePipeline() {
+    stop();
+    if (_encoder.joinable()) _encoder.join();
+    if (_writer.joinable()) _writer.join();
+}
+
+void FramePipeline::push(Image p_frame) {
+    if (!_frames.push(std::move(p_frame))) {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (_error) std::rethrow_exception(_error);
+    }
+}
+
+void FramePipeline::finish() {
+    _frames.close();
+    if (_encoder.joinable()) _encoder.join();
+    if (_writer.joinable()) _writer.join();
+    if (_error) std::rethrow_exception(_error);
+
+    if (!_video) return;
+    _stream->flush();
+    if (_file.is_open()) _file.close();
+    if (!*_stream) throw ImageWriteError(_output, "write failed");
+}
+
+void FramePipeline::encodeLoop() {
+    try {
+        Image frame;
+        while (_frames.pop(frame)) {
+            std::vector<uint8_t> encoded;
+            if (_video) {
+                encoded = encodeVideoFrame(frame);
+            } else {
+                std::ostringstream stream;
+                std::unique_ptr<IImageWriter> writer;
+                if (isPngPath(_output)) {
+                    writer = std::make_unique<PngWriter>(stream, frame.width, frame.height, _scheduler);
+                } else {
+                    writer = std::make_unique<PpmWriter>(stream, frame.width, frame.height);
+                }
+                writer->writeRows(frame.pixels.data(), frame.height);
+                writer->finish();
+                const std::string bytes = stream.str();
+                encoded.assign(bytes.begin(), bytes.end());
+            }
+            if (!_encodedFrames.push(std::move(encoded))) return;
+        }
+    } catch (...) { fail(std::current_exception()); }
+    _encodedFrames.close();
+}
+
+void FramePipeline::writeLoop() {
+    try {
+        std::vector<uint8_t> encoded;
+        while (_encodedFrames.pop(encoded)) {
+            if (_video) {
+                _stream->write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+                if (!*_stream) throw ImageWriteError(_output, "write failed");
+            } else {
+                const std::string path = getFramePath(_writtenFrames);
+                std::ofstream file(path, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+                file.close();
+                if (!file) throw ImageWriteError(path, "write failed");
+            }
+            _writtenFrames++;
+        }
+    } catch (...) { fail(std::current_exception()); }
+}
+
+std::vector<uint8_t> FramePipeline::encodeVideoFrame(const Image& p_frame) {
+    if (p_frame.width != _width || p_frame.height != _height) throw ImageWriteError(_output, "frame size changed");
+
+    static const std::string header = "FRAME\n";
+    const int chromaWidth = (_width + 1) / 2;
+    const int chromaHeight = (_height + 1) / 2;
+    const size_t lumaSize = static_cast<size_t>(_width) * _height;
+    const size_t chromaSize = static_cast<size_t>(chromaWidth) * chromaHeight;
+
+    std::vector<uint8_t> encoded(header.size() + lumaSize + 2 * chromaSize);
+    std::copy(header.begin(), header.end(), encoded.begin());
+    uint8_t* const luma = encoded.data() + header.size();
+    uint8_t* const blue = luma + lumaSize;
+    uint8_t* const red = blue + chromaSize;
+
+    std::vector<Tile> bands;
+    for (int y = 0; y < _height; y += CONVERSION_ROWS) {
+        bands.push_back({0, y, _width, std::min(CONVERSION_ROWS, _height - y)});
+    }
+    _scheduler.run(bands, [&](const Tile& p_band, unsigned) {
+        for (int y = p_band.y; y < p_band.y + p_band.height; y++) {
+            const uint8_t* rgb = &p_frame.pixels[static_cast<size_t>(y) * _width * 3];
+            for (int x = 0; x < _width; x++, rgb += 3) {
+                luma[static_cast<size_t>(y) * _width + x] =
+                    toByte(16.0 + (65.481 * rgb[0] + 128.553 * rgb[1] + 24.966 * rgb[2]) / 255.0);
+            }
+        }
+
+        // Chroma of the average of each 2x2 block
+        for (int cy = p_band.y / 2; cy < (p_band.y + p_band.height + 1) / 2; cy++) {
+            for (int cx = 0; cx < chromaWidth; cx++) {
+                double sum[3] = {};
+                int count = 0;
+                for (int y = 2 * cy; y < std::min(2 * cy + 2, _height); y++) {
+                    for (int x = 2 * cx; x < std::min(2 * cx + 2, _width); x++, count++) {
+                        const uint8_t* pixel = &p_frame.pixels[(static_cast<size_t>(y) * _width + x) * 3];
+                        for (int channel = 0; channel < 3; channel++) { sum[channel] += pixel[channel]; }
+                    }
+                }
+                const double r = sum[0] / count, g = sum[1] / count, b = sum[2] / count;
+                const size_t index = static_cast<size_t>(cy) * chromaWidth + cx;
+                blue[index] = toByte(128.0 + (-37.797 * r - 74.203 * g + 112.0 * b) / 255.0);
+                red[index] = toByte(128.0 + (112.0 * r - 93.786 * g - 18.214 * b) / 255.0);
+            }
+        }
+    });
+    return encoded;
+}
+
+void FramePipeline::parseFramePattern() {
+    // The name comes from the command line, so it's never handed to printf: only the frame number is substituted
+    bool found = false;
+    std::string* part = &_framePrefix;
+    for (size_t i = 0; i < _output.size(); i++) {
+        if (_output[i] != '%') {
+            *part += _output[i];
+            continue;
+        }
+        if (i + 1 < _output.size() && _output[i + 1] == '%') {
+            *part += '%';
+            i++;
+            continue;
+        }
+
+        // %d or %0Nd
+        size_t end = i + 1;
+        int digits = 0;
+        if (end < _output.size() && _output[end] == '0') {
+            while (++end < _output.size() && std::isdigit(static_cast<unsigned char>(_output[end])) && digits < 100) {
+                digits = 10 * digits + (_output[end] - '0');
+            }
+        }
+        if (found || end >= _output.size() || _output[end] != 'd' || digits > 32) {
+            throw ImageWriteError(_output, "the name may only contain a single %d or %0Nd");
+        }
+        found = true;
+        _frameDigits = digits;
+        part = &_frameSuffix;
+        i = end;
+    }
+    if (found) return;
+
+    // Without a frame number, it's appended to the name
+    _framePrefix = _output;
+    _frameDigits = 5;
+    const size_t extension = _output.rfind('.');
+    const size_t directory = _output.find_last_of("/\\");
+    if (extension != std::string::npos && (directory == std::string::npos || extension > directory)) {
+        _framePrefix = _output.substr(0, extension) + "_";
+        _frameSuffix = _output.substr(extension);
+    } else {
+        _framePrefix += "_";
+    }
+}
+
+std::string FramePipeline::getFramePath(int p_index) const {
+    std::string number = std::to_string(p_index);
+    if (number.size() < static_cast<size_t>(_frameDigits)) number.insert(0, _frameDigits - number.size(), '0');
+    return _framePrefix + number + _frameSuffix;
+}
+
+void FramePipeline::fail(std::exception_ptr p_error) {
+    {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (!_error) _error = p_error;
+    }
+    stop();
+}
+
+void FramePipeline::stop() {
+    _frames.close();
+    _encodedFrames.close();
+}
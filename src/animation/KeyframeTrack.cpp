@@ -0,0 +1,88 @@
+#include <animation/KeyframeTrack.hpp>
+#include <exception/KeyframeError.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    // Enough fraction limbs for every digit of p_text
+    int fractionLimbsOf(const std::string& p_text) {
+        const size_t point = p_text.find('.');
+        const size_t digits = point == std::string::npos ? 0 : p_text.size() - point - 1;
+        return std::max(1, static_cast<int>(std::ceil(digits * std::log2(10.0) / 64.0)) + 1);
+    }
+
+    double log2(const FloatExp& p_value) { return p_value.log() / std::log(2.0); }
+}
+
+KeyframeTrack::KeyframeTrack(const std::string& p_path) {
+    std::ifstream file(p_path);
+    if (!file) throw KeyframeError(p_path, "can't be opened");
+
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string frame, real, imaginary, scale, iterations;
+        if (!(fields >> frame)) continue;
+
+        const std::string position = "line " + std::to_string(lineNumber);
+        if (!(fields >> real >> imaginary >> scale >> iterations)) {
+            throw KeyframeError(p_path, position + ": expected <frame> <real> <imaginary> <scale> <iterations>");
+        }
+        try {
+            const int limbs = std::max(fractionLimbsOf(real), fractionLimbsOf(imaginary));
+            Keyframe keyframe = {std::stoi(frame),
+                                 FixedPoint::fromString(real, limbs),
+                                 FixedPoint::fromString(imaginary, limbs),
+                                 FloatExp::fromString(scale),
+                                 std::stoi(iterations)};
+            if (keyframe.frame < 0 || (!_keyframes.empty() && keyframe.frame <= _keyframes.back().frame)) {
+                throw KeyframeError(p_path, position + ": frames must increase");
+            }
+            if (!(keyframe.scale > FloatExp(0.0)) || keyframe.maxIterations <= 0) {
+                throw KeyframeError(p_path, position + ": scale and iterations must be positive");
+            }
+            _keyframes.push_back(std::move(keyframe));
+        } catch (const std::logic_error&) {
+            // std::invalid_argument and std::out_of_range of the number parsing
+            throw KeyframeError(p_path, position + ": invalid number");
+        }
+    }
+    if (_keyframes.empty()) throw KeyframeError(p_path, "no keyframes");
+}
+
+Keyframe KeyframeTrack::at(int p_frame) const {
+    // The first keyframe holds until its frame, the last one ends the animation
+    auto next = std::upper_bound(_keyframes.begin(), _keyframes.end(), p_frame,
+                                 [](int p_value, const Keyframe& p_keyframe) { return p_value < p_keyframe.frame; });
+    if (next == _keyframes.begin()) return _keyframes.front();
+    if (next == _keyframes.end()) return _keyframes.back();
+    const Keyframe& previous = *(next - 1);
+    if (p_frame == previous.frame) return previous;
+    const double t = static_cast<double>(p_frame - previous.frame) / (next->frame - previous.frame);
+
+    Keyframe result = {p_frame, next->real, next->imaginary, {}, 0};
+    const double scaleLog = (1.0 - t) * log2(previous.scale) + t * log2(next->scale);
+    const double scaleExponent = std::floor(scaleLog);
+    result.scale = FloatExp::normalized(std::exp2(scaleLog - scaleExponent), static_cast<int64_t>(scaleExponent));
+    result.maxIterations =
+        static_cast<int>(std::lround(previous.maxIterations + t * (next->maxIterations - previous.maxIterations)));
+
+    // Remaining distance to the next center: 1 at the previous keyframe, 0 at the next one
+    const FloatExp scaleChange = previous.scale - next->scale;
+    const double remaining = scaleChange.isZero() ? 1.0 - t : ((result.scale - next->scale) / scaleChange).toDouble();
+    const int limbs = std::max(next->real.getFractionLimbs(), previous.real.getFractionLimbs());
+    result.real += FixedPoint((previous.real - next->real).toFloatExp() * FloatExp(remaining), limbs);
+    result.imaginary += FixedPoint((previous.imaginary - next->imaginary).toFloatExp() * FloatExp(remaining), limbs);
+    return result;
+}
+
+bool KeyframeTrack::hasFixedCenter() const {
+    return std::all_of(_keyframes.begin(), _keyframes.end(), [this](const Keyframe& p_keyframe) {
+        return p_keyframe.real == _keyframes.front().real && p_keyframe.imaginary == _keyframes.front().imaginary;
+    });
+}
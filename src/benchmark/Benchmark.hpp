@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cpu/IterationBuffer.hpp>
+#include <cpu/Viewport.hpp>
+
+#include <chrono>
+#include <ratio>
+
+/**
+ * Helpers shared by the micro-benchmarks.
+ */
+
+/**
+ * Average run time of p_function. It's repeated until the measurement takes long enough to be stable.
+ *
+ * @tparam Period Unit of the result, e.g. std::milli or std::nano.
+ * @param p_minimumDuration Total time to spend, longer for more stable results.
+ */
+template <typename Period = std::milli, typename Function>
+double measureTime(Function p_function, std::chrono::milliseconds p_minimumDuration = std::chrono::milliseconds(500)) {
+    int repetitions = 0;
+    const auto start = std::chrono::steady_clock::now();
+    auto end = start;
+    do {
+        p_function();
+        repetitions++;
+        end = std::chrono::steady_clock::now();
+    } while (end - start < p_minimumDuration);
+
+    return std::chrono::duration<double, Period>(end - start).count() / repetitions;
+}
+
+// Full HD, the frames the render benchmarks compute
+constexpr int frameWidth = 1920;
+constexpr int frameHeight = 1080;
+
+/**
+ * Views with different amounts of interior: the whole set, mostly the main cardioid, the period-3 minibrot, and the
+ * boundary in the seahorse and the elephant valley.
+ */
+inline const Viewport standardViewports[] = {{{-0.5, 0.0}, FloatExp(3.5), 1000},
+                                             {{-0.2, 0.0}, FloatExp(1.0), 5000},
+                                             {{-1.7548776, 0.0}, FloatExp(0.002), 5000},
+                                             {{-0.745428, 0.11301201}, FloatExp(0.01), 1000},
+                                             {{0.26055793, 0.0017685117}, FloatExp(1e-4), 1000}};
+
+/**
+ * @return Number of pixels, which differ between two buffers of the same size.
+ */
+inline int countDifferences(const IterationBuffer& p_a, const IterationBuffer& p_b) {
+    int differences = 0;
+    for (int y = 0; y < p_a.getHeight(); y++) {
+        for (int x = 0; x < p_a.getWidth(); x++) differences += p_a.at(x, y) != p_b.at(x, y);
+    }
+    return differences;
+}
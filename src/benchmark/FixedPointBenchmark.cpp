@@ -0,0 +1,55 @@
+#include "Benchmark.hpp"
+
+#include <perturbation/ReferenceOrbit.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+/**
+ * Micro-benchmark: cost of a reference orbit iteration in FixedPoint, depending on the precision, compared to double.
+ */
+namespace {
+    constexpr int iterations = 2000;
+
+    // Inside of the main cardioid, the orbit never escapes
+    constexpr double real = -0.1;
+    constexpr double imaginary = 0.1;
+}
+
+int main() {
+    volatile double sink = 0.0;
+
+    const double doubleTime = measureTime<std::nano>([&]() {
+        double zReal = 0.0, zImaginary = 0.0;
+        for (int i = 0; i < iterations; i++) {
+            const double nextReal = zReal * zReal - zImaginary * zImaginary + real;
+            zImaginary = 2.0 * zReal * zImaginary + imaginary;
+            zReal = nextReal;
+        }
+        sink = zReal;
+    }, std::chrono::milliseconds(200));
+    std::cout << "double: " << std::fixed << std::setprecision(2) << doubleTime / iterations << " ns/iteration"
+              << std::endl;
+
+    std::cout << std::setw(8) << "digits" << std::setw(8) << "limbs" << std::setw(16) << "ns/iteration"
+              << std::setw(16) << "ns/digit" << std::setw(12) << "x double" << std::endl;
+
+    for (int digits : {20, 50, 100, 200, 300, 500, 1000, 2000, 5000}) {
+        // log2(10) bits per decimal digit plus one guard limb
+        const int limbs = static_cast<int>(std::ceil(digits * std::log2(10.0) / 64.0)) + 1;
+
+        ReferenceOrbit orbit;
+        const FixedPoint cReal(real, limbs);
+        const FixedPoint cImaginary(imaginary, limbs);
+        const double time = measureTime<std::nano>([&]() {
+            orbit.compute(cReal, cImaginary, iterations);
+            sink = orbit.getReal(iterations);
+        }, std::chrono::milliseconds(200));
+
+        const double perIteration = time / iterations;
+        std::cout << std::setw(8) << digits << std::setw(8) << limbs << std::setw(16) << perIteration << std::setw(16)
+                  << perIteration / digits << std::setw(12) << perIteration / (doubleTime / iterations) << std::endl;
+    }
+}
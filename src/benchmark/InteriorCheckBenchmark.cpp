@@ -0,0 +1,51 @@
+#include "Benchmark.hpp"
+
+#include <cpu/CpuRenderer.hpp>
+#include <cpu/SimdMandelbrotKernel.hpp>
+
+#include <iomanip>
+#include <iostream>
+
+/**
+ * Micro-benchmark: render time of Full HD frames without interior shortcuts, with the cardioid/bulb test
+ * (Viewport::interiorCheck), with the periodicity detection (Viewport::periodicityCheck) and with both, for views with
+ * different amounts of interior. The cardioid test must not change any pixel, the periodicity detection may misjudge
+ * pixels within its tolerance of the boundary, those are counted.
+ */
+int main() {
+    CpuRenderer renderer;
+    SimdMandelbrotKernel kernel;
+
+    std::cout << std::setw(12) << "scale" << std::setw(12) << "iterations" << std::setw(12) << "plain ms"
+              << std::setw(12) << "cardioid" << std::setw(12) << "periodic" << std::setw(12) << "both"
+              << std::setw(12) << "stopped" << std::setw(12) << "changed" << std::endl;
+
+    for (const Viewport& viewport : standardViewports) {
+        double times[4];
+        IterationBuffer buffers[4] = {IterationBuffer(frameWidth, frameHeight),
+                                      IterationBuffer(frameWidth, frameHeight),
+                                      IterationBuffer(frameWidth, frameHeight),
+                                      IterationBuffer(frameWidth, frameHeight)};
+        uint64_t periodicPixels = 0;
+        for (int mode = 0; mode < 4; mode++) {
+            Viewport variant = viewport;
+            variant.interiorCheck = mode & 1;
+            variant.periodicityCheck = mode & 2;
+            times[mode] = measureTime([&]() {
+                kernel.resetStatistics();
+                renderer.render(variant, kernel, buffers[mode]);
+            });
+            if (mode == 2) periodicPixels = kernel.getPeriodicPixels();
+        }
+
+        if (countDifferences(buffers[0], buffers[1]) != 0) {
+            std::cerr << "The cardioid test changed pixels" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::setw(12) << viewport.scale.toString() << std::setw(12) << viewport.maxIterations
+                  << std::fixed << std::setprecision(2) << std::setw(12) << times[0] << std::setw(12) << times[1]
+                  << std::setw(12) << times[2] << std::setw(12) << times[3] << std::defaultfloat << std::setw(12)
+                  << periodicPixels << std::setw(12) << countDifferences(buffers[0], buffers[2]) << std::endl;
+    }
+}
@@ -0,0 +1,52 @@
+#include "Benchmark.hpp"
+
+#include <compression/IterationCodec.hpp>
+#include <cpu/CpuRenderer.hpp>
+#include <cpu/SimdMandelbrotKernel.hpp>
+
+#include <iomanip>
+#include <iostream>
+
+/**
+ * Micro-benchmark: size and speed of IterationCodec on Full HD frames, compared to computing them on all cores.
+ */
+int main() {
+    CpuRenderer renderer;
+    SimdMandelbrotKernel kernel;
+
+    const Viewport viewports[] = {{{-0.5, 0.0}, FloatExp(3.5), 1000},
+                                  {{-0.745428, 0.11301201}, FloatExp(0.01), 1000},
+                                  {{-1.74997970, 0.0}, FloatExp(1e-6), 1000},
+                                  {{0.26055793, 0.0017685117}, FloatExp(1e-4), 1000}};
+
+    std::cout << std::setw(12) << "scale" << std::setw(10) << "ratio" << std::setw(12) << "bits/px" << std::setw(14)
+              << "encode ms" << std::setw(14) << "decode ms" << std::setw(14) << "render ms" << std::endl;
+
+    for (const Viewport& viewport : viewports) {
+        IterationBuffer buffer(frameWidth, frameHeight);
+        const double renderTime = measureTime([&]() { renderer.render(viewport, kernel, buffer); });
+
+        std::vector<uint8_t> encoded;
+        const double encodeTime = measureTime([&]() { encoded = IterationCodec::encode(buffer); });
+
+        IterationBuffer decoded;
+        const double decodeTime =
+            measureTime([&]() { IterationCodec::decode(encoded.data(), encoded.size(), decoded); });
+
+        for (int y = 0; y < frameHeight; y++) {
+            for (int x = 0; x < frameWidth; x++) {
+                if (decoded.at(x, y) != buffer.at(x, y)) {
+                    std::cerr << "Round trip failed at " << x << ", " << y << std::endl;
+                    return 1;
+                }
+            }
+        }
+
+        const double rawSize = static_cast<double>(frameWidth) * frameHeight * sizeof(uint32_t);
+        std::cout << std::setw(12) << viewport.scale.toString() << std::fixed << std::setprecision(1) << std::setw(10)
+                  << rawSize / encoded.size() << std::setprecision(2) << std::setw(12)
+                  << 8.0 * encoded.size() / (static_cast<double>(frameWidth) * frameHeight) << std::setw(14)
+                  << encodeTime << std::setw(14) << decodeTime << std::setw(14) << renderTime << std::defaultfloat
+                  << std::endl;
+    }
+}
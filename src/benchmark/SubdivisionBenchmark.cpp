@@ -0,0 +1,45 @@
+#include "Benchmark.hpp"
+
+#include <cpu/CpuRenderer.hpp>
+#include <cpu/SimdMandelbrotKernel.hpp>
+
+#include <iomanip>
+#include <iostream>
+
+/**
+ * Micro-benchmark: render time of Full HD frames with every Subdivision mode, verified against the brute-force frame.
+ * Pixels, which differ from it, are counted: a few for interior fills (samples in the cusp of a bulb attachment), more
+ * for uniform fills (lost filaments).
+ */
+int main() {
+    CpuRenderer renderer;
+    SimdMandelbrotKernel kernel;
+
+    const Subdivision subdivisions[] = {Subdivision::Off, Subdivision::Interior, Subdivision::Uniform};
+
+    std::cout << std::setw(12) << "scale" << std::setw(12) << "iterations" << std::setw(12) << "off ms"
+              << std::setw(12) << "interior" << std::setw(12) << "uniform" << std::setw(12) << "filled"
+              << std::setw(12) << "changed" << std::setw(12) << "filled" << std::setw(12) << "changed" << std::endl;
+
+    for (const Viewport& viewport : standardViewports) {
+        double times[3];
+        uint64_t filledPixels[3];
+        IterationBuffer buffers[3] = {IterationBuffer(frameWidth, frameHeight),
+                                      IterationBuffer(frameWidth, frameHeight),
+                                      IterationBuffer(frameWidth, frameHeight)};
+        for (int mode = 0; mode < 3; mode++) {
+            renderer.setSubdivision(subdivisions[mode]);
+            times[mode] = measureTime([&]() {
+                renderer.resetStatistics();
+                renderer.render(viewport, kernel, buffers[mode]);
+            });
+            filledPixels[mode] = renderer.getFilledPixels();
+        }
+
+        std::cout << std::setw(12) << viewport.scale.toString() << std::setw(12) << viewport.maxIterations
+                  << std::fixed << std::setprecision(2) << std::setw(12) << times[0] << std::setw(12) << times[1]
+                  << std::setw(12) << times[2] << std::defaultfloat << std::setw(12) << filledPixels[1]
+                  << std::setw(12) << countDifferences(buffers[0], buffers[1]) << std::setw(12) << filledPixels[2]
+                  << std::setw(12) << countDifferences(buffers[0], buffers[2]) << std::endl;
+    }
+}
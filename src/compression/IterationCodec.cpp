@@ -0,0 +1,277 @@
+#include <compression/IterationCodec.hpp>
+#include <exception/IterationCodecError.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <string>
+
+namespace {
+    constexpr char MAGIC[8] = {'G', 'L', 'F', 'X', 'I', 'T', 'E', 'R'};
+    constexpr uint32_t VERSION = 1;
+
+    // Residuals below 16 are tokens of their own, a residual with its highest bit n (4 ... 31) becomes the token
+    // 12 + n, followed by its n lower bits
+    constexpr uint32_t DIRECT_TOKENS = 16;
+    constexpr int TOKEN_COUNT = DIRECT_TOKENS + 28;
+
+    constexpr int PROBABILITY_BITS = 12;
+    constexpr uint32_t PROBABILITY_SCALE = 1u << PROBABILITY_BITS;
+    // Lower bound of the normalized rANS state, it's kept in [RANS_LOW, RANS_LOW << 8)
+    constexpr uint32_t RANS_LOW = 1u << 23;
+
+    // Largest frame accepted by decode: 16384 x 16384 (the usual GL_MAX_TEXTURE_SIZE), 1 GiB of counts
+    constexpr uint64_t MAX_PIXELS = uint64_t(1) << 28;
+
+    constexpr size_t HEADER_SIZE = sizeof(MAGIC) + 3 * sizeof(uint32_t) + TOKEN_COUNT * sizeof(uint16_t) +
+                                   sizeof(uint64_t);
+
+    // Median edge detector (LOCO-I): p_left, p_below and p_belowLeft are the neighbours already known to the decoder
+    inline uint32_t predict(uint32_t p_left, uint32_t p_below, uint32_t p_belowLeft) {
+        if (p_belowLeft >= std::max(p_left, p_below)) return std::min(p_left, p_below);
+        if (p_belowLeft <= std::min(p_left, p_below)) return std::max(p_left, p_below);
+        return p_left + p_below - p_belowLeft;
+    }
+
+    // Prediction of pixel x of a row, p_below is nullptr for the first row
+    inline uint32_t predict(const uint32_t* p_row, const uint32_t* p_below, int p_x) {
+        if (!p_below) return p_x > 0 ? p_row[p_x - 1] : 0;
+        if (p_x == 0) return p_below[0];
+        return predict(p_row[p_x - 1], p_below[p_x], p_below[p_x - 1]);
+    }
+
+    inline int highestBit(uint32_t p_value) {
+        int bit = 0;
+        for (int step = 16; step > 0; step >>= 1) {
+            if (p_value >> (bit + step)) { bit += step; }
+        }
+        return bit;
+    }
+
+    // Extra bits, least significant first
+    class BitWriter {
+        public:
+            void write(uint32_t p_value, int p_bits) {
+                _buffer |= static_cast<uint64_t>(p_value) << _count;
+                _count += p_bits;
+                while (_count >= 8) {
+                    _bytes.push_back(static_cast<uint8_t>(_buffer));
+                    _buffer >>= 8;
+                    _count -= 8;
+                }
+            }
+
+            const std::vector<uint8_t>& finish() {
+                if (_count > 0) { _bytes.push_back(static_cast<uint8_t>(_buffer)); }
+                _buffer = 0;
+                _count = 0;
+                return _bytes;
+            }
+
+        private:
+            std::vector<uint8_t> _bytes;
+            uint64_t _buffer = 0;
+            int _count = 0;
+    };
+
+    class BitReader {
+        public:
+            BitReader(const uint8_t* p_data, const uint8_t* p_end) : _data(p_data), _end(p_end) {}
+
+            uint32_t read(int p_bits) {
+                while (_count < p_bits) {
+                    if (_data == _end) throw IterationCodecError("extra bits truncated");
+                    _buffer |= static_cast<uint64_t>(*_data++) << _count;
+                    _count += 8;
+                }
+                const uint32_t value = static_cast<uint32_t>(_buffer & ((uint64_t(1) << p_bits) - 1));
+                _buffer >>= p_bits;
+                _count -= p_bits;
+                return value;
+            }
+
+        private:
+            const uint8_t* _data;
+            const uint8_t* _end;
+            uint64_t _buffer = 0;
+            int _count = 0;
+    };
+
+    void put(std::vector<uint8_t>& p_out, uint64_t p_value, int p_bytes) {
+        for (int i = 0; i < p_bytes; i++) { p_out.push_back(static_cast<uint8_t>(p_value >> (8 * i))); }
+    }
+
+    uint64_t get(const uint8_t*& p_data, int p_bytes) {
+        uint64_t value = 0;
+        for (int i = 0; i < p_bytes; i++) { value |= static_cast<uint64_t>(*p_data++) << (8 * i); }
+        return value;
+    }
+
+    // Scale the counts to PROBABILITY_SCALE, every used token keeps at least 1
+    void normalize(const uint64_t* p_counts, uint64_t p_total, uint32_t* p_frequencies) {
+        if (p_total == 0) {
+            std::fill(p_frequencies, p_frequencies + TOKEN_COUNT, 0);
+            return;
+        }
+
+        uint32_t sum = 0;
+        int largest = 0;
+        for (int token = 0; token < TOKEN_COUNT; token++) {
+            p_frequencies[token] = p_counts[token] == 0
+                                       ? 0
+                                       : static_cast<uint32_t>(
+                                             std::max<uint64_t>(1, p_counts[token] * PROBABILITY_SCALE / p_total));
+            sum += p_frequencies[token];
+            if (p_counts[token] > p_counts[largest]) { largest = token; }
+        }
+        // Rounding error, at most TOKEN_COUNT, the largest token has far more than that
+        p_frequencies[largest] += PROBABILITY_SCALE - sum;
+    }
+}
+
+std::vector<uint8_t> IterationCodec::encode(const IterationBuffer& p_buffer) {
+    const int width = p_buffer.getWidth();
+    const int height = p_buffer.getHeight();
+    const size_t pixels = static_cast<size_t>(width) * height;
+
+    // Residuals of the prediction as tokens plus extra bits
+    std::vector<uint8_t> tokens(pixels);
+    BitWriter extraBits;
+    uint64_t counts[TOKEN_COUNT] = {};
+    for (int y = 0; y < height; y++) {
+        const uint32_t* row = &p_buffer.getData()[static_cast<size_t>(y) * width];
+        const uint32_t* below = y > 0 ? row - width : nullptr;
+        for (int x = 0; x < width; x++) {
+            // Zigzag, small negative residuals map to small values as well
+            const uint32_t residual = row[x] - predict(row, below, x);
+            const uint32_t value = (residual << 1) ^ (0u - (residual >> 31));
+
+            uint8_t token;
+            if (value < DIRECT_TOKENS) {
+                token = static_cast<uint8_t>(value);
+            } else {
+                const int bit = highestBit(value);
+                token = static_cast<uint8_t>(12 + bit);
+                extraBits.write(value - (1u << bit), bit);
+            }
+            tokens[static_cast<size_t>(y) * width + x] = token;
+            counts[token]++;
+        }
+    }
+
+    uint32_t frequencies[TOKEN_COUNT];
+    uint32_t starts[TOKEN_COUNT];
+    normalize(counts, pixels, frequencies);
+    for (int token = 0, start = 0; token < TOKEN_COUNT; token++) {
+        starts[token] = start;
+        start += frequencies[token];
+    }
+
+    // rANS works like a stack: encode backwards, so the decoder reads forwards
+    std::vector<uint8_t> stream;
+    uint32_t state = RANS_LOW;
+    for (size_t i = pixels; i-- > 0;) {
+        const uint32_t frequency = frequencies[tokens[i]];
+        const uint32_t maxState = ((RANS_LOW >> PROBABILITY_BITS) << 8) * frequency;
+        while (state >= maxState) {
+            stream.push_back(static_cast<uint8_t>(state));
+            state >>= 8;
+        }
+        state = ((state / frequency) << PROBABILITY_BITS) + state % frequency + starts[tokens[i]];
+    }
+    for (int i = 0; i < 4; i++) {
+        stream.push_back(static_cast<uint8_t>(state));
+        state >>= 8;
+    }
+    std::reverse(stream.begin(), stream.end());
+
+    const std::vector<uint8_t>& extra = extraBits.finish();
+    std::vector<uint8_t> out;
+    out.reserve(HEADER_SIZE + stream.size() + extra.size());
+    for (char character : MAGIC) { out.push_back(static_cast<uint8_t>(character)); }
+    put(out, VERSION, 4);
+    put(out, static_cast<uint32_t>(width), 4);
+    put(out, static_cast<uint32_t>(height), 4);
+    for (int token = 0; token < TOKEN_COUNT; token++) { put(out, frequencies[token], 2); }
+    put(out, stream.size(), 8);
+    out.insert(out.end(), stream.begin(), stream.end());
+    out.insert(out.end(), extra.begin(), extra.end());
+    return out;
+}
+
+void IterationCodec::decode(const uint8_t* p_data, size_t p_size, IterationBuffer& p_buffer) {
+    const uint8_t* const end = p_data + p_size;
+    if (p_size < HEADER_SIZE || std::memcmp(p_data, MAGIC, sizeof(MAGIC)) != 0) {
+        throw IterationCodecError("missing header");
+    }
+    const uint8_t* data = p_data + sizeof(MAGIC);
+    if (get(data, 4) != VERSION) throw IterationCodecError("unsupported version");
+
+    const uint64_t width = get(data, 4);
+    const uint64_t height = get(data, 4);
+    if (width > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+        height > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        throw IterationCodecError("invalid size");
+    }
+    // Checked before anything is allocated, a corrupted header must not request gigabytes. Both factors are below
+    // 2^31, so the product doesn't overflow.
+    const uint64_t pixels = width * height;
+    if (pixels > MAX_PIXELS) throw IterationCodecError("size exceeds " + std::to_string(MAX_PIXELS) + " pixels");
+
+    uint32_t frequencies[TOKEN_COUNT];
+    uint32_t starts[TOKEN_COUNT];
+    uint32_t sum = 0;
+    for (int token = 0; token < TOKEN_COUNT; token++) {
+        frequencies[token] = static_cast<uint32_t>(get(data, 2));
+        starts[token] = sum;
+        sum += frequencies[token];
+    }
+    if (pixels > 0 && sum != PROBABILITY_SCALE) throw IterationCodecError("invalid token frequencies");
+
+    const uint64_t streamSize = get(data, 8);
+    if (streamSize > static_cast<uint64_t>(end - data) || (pixels > 0 && streamSize < 4)) {
+        throw IterationCodecError("rANS stream truncated");
+    }
+    const uint8_t* stream = data;
+    const uint8_t* const streamEnd = data + streamSize;
+    BitReader extraBits(streamEnd, end);
+
+    try {
+        p_buffer.resize(static_cast<int>(width), static_cast<int>(height));
+    } catch (const std::bad_alloc&) {
+        throw IterationCodecError("not enough memory for " + std::to_string(pixels) + " pixels");
+    }
+    if (pixels == 0) return;
+
+    // Slot of the cumulative distribution -> token
+    uint8_t tokenOf[PROBABILITY_SCALE];
+    for (int token = 0; token < TOKEN_COUNT; token++) {
+        std::fill(tokenOf + starts[token], tokenOf + starts[token] + frequencies[token], static_cast<uint8_t>(token));
+    }
+
+    uint32_t state = 0;
+    for (int i = 0; i < 4; i++) { state = (state << 8) | *stream++; }
+
+    for (uint64_t y = 0; y < height; y++) {
+        uint32_t* row = &p_buffer.getData()[y * width];
+        const uint32_t* below = y > 0 ? row - width : nullptr;
+        for (uint64_t x = 0; x < width; x++) {
+            const uint32_t slot = state & (PROBABILITY_SCALE - 1);
+            const uint8_t token = tokenOf[slot];
+            state = frequencies[token] * (state >> PROBABILITY_BITS) + slot - starts[token];
+            while (state < RANS_LOW) {
+                if (stream == streamEnd) throw IterationCodecError("rANS stream truncated");
+                state = (state << 8) | *stream++;
+            }
+
+            uint32_t value = token;
+            if (token >= DIRECT_TOKENS) {
+                const int bit = token - 12;
+                value = (1u << bit) + extraBits.read(bit);
+            }
+            const uint32_t residual = (value >> 1) ^ (0u - (value & 1));
+            row[x] = predict(row, below, static_cast<int>(x)) + residual;
+        }
+    }
+}
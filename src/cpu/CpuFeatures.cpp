@@ -0,0 +1,80 @@
+#include <cpu/CpuFeatures.hpp>
+
+#if defined(CPU_RENDERER_X86_SIMD)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#include <cstdint>
+
+namespace {
+#if defined(CPU_RENDERER_X86_SIMD)
+    void cpuid(unsigned p_leaf, unsigned p_subLeaf, unsigned p_registers[4]) {
+#if defined(_MSC_VER)
+        int registers[4];
+        __cpuidex(registers, static_cast<int>(p_leaf), static_cast<int>(p_subLeaf));
+        for (int i = 0; i < 4; i++) p_registers[i] = static_cast<unsigned>(registers[i]);
+#else
+        __cpuid_count(p_leaf, p_subLeaf, p_registers[0], p_registers[1], p_registers[2], p_registers[3]);
+#endif
+    }
+
+    // Register state enabled by the operating system (XCR0)
+    uint64_t readExtendedControlRegister() {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        uint32_t eax, edx;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+    }
+
+    SimdLevel queryCpu() {
+        unsigned registers[4];
+        cpuid(0, 0, registers);
+        const unsigned maxLeaf = registers[0];
+
+        cpuid(1, 0, registers);
+        if (!(registers[3] & (1u << 26))) return SimdLevel::Scalar;  // SSE2
+
+        // AVX needs both the CPU (AVX, OSXSAVE) and the OS (XMM + YMM state) to cooperate
+        const bool osxsave = registers[2] & (1u << 27);
+        const bool avx = registers[2] & (1u << 28);
+        if (!osxsave || !avx || maxLeaf < 7) return SimdLevel::SSE2;
+
+        const uint64_t xcr0 = readExtendedControlRegister();
+        if ((xcr0 & 0x6) != 0x6) return SimdLevel::SSE2;
+
+        cpuid(7, 0, registers);
+        const bool avx2 = registers[1] & (1u << 5);
+        const bool avx512f = registers[1] & (1u << 16);
+
+        // Opmask, upper ZMM0-15 and ZMM16-31 state
+        if (avx512f && (xcr0 & 0xE0) == 0xE0) return SimdLevel::AVX512;
+        if (avx2) return SimdLevel::AVX2;
+        return SimdLevel::SSE2;
+    }
+#endif
+}
+
+SimdLevel detectSimdLevel() {
+#if defined(CPU_RENDERER_X86_SIMD)
+    static const SimdLevel level = queryCpu();
+    return level;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+const char* getSimdLevelName(SimdLevel p_level) {
+    switch (p_level) {
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+        default: return "Scalar";
+    }
+}
@@ -0,0 +1,130 @@
+#include <cpu/CpuRenderer.hpp>
+
+#include <algorithm>
+
+namespace {
+    void computeIfNotEmpty(const Viewport& p_viewport,
+                           IEscapeTimeKernel& p_kernel,
+                           IterationBuffer& p_buffer,
+                           const Tile& p_tile) {
+        if (p_tile.width > 0 && p_tile.height > 0) p_kernel.renderTile(p_viewport, p_tile, p_buffer);
+    }
+
+    struct Border {
+        // Whether all pixels hold the value of the first one
+        bool uniform = true;
+        uint32_t value;
+        bool touchesInterior = false;
+    };
+
+    Border scanBorder(const IterationBuffer& p_buffer, const Tile& p_rectangle, uint32_t p_interior) {
+        Border border;
+        border.value = p_buffer.at(p_rectangle.x, p_rectangle.y);
+        auto visit = [&](int p_x, int p_y) {
+            const uint32_t value = p_buffer.at(p_x, p_y);
+            border.uniform &= value == border.value;
+            border.touchesInterior |= value == p_interior;
+        };
+
+        const int right = p_rectangle.x + p_rectangle.width - 1;
+        const int top = p_rectangle.y + p_rectangle.height - 1;
+        for (int x = p_rectangle.x; x <= right; x++) {
+            visit(x, p_rectangle.y);
+            visit(x, top);
+        }
+        for (int y = p_rectangle.y + 1; y < top; y++) {
+            visit(p_rectangle.x, y);
+            visit(right, y);
+        }
+        return border;
+    }
+}
+
+CpuRenderer::CpuRenderer(unsigned p_threadCount, int p_tileSize)
+    : _scheduler(p_threadCount), _tileSize(p_tileSize) {}
+
+void CpuRenderer::render(const Viewport& p_viewport, IEscapeTimeKernel& p_kernel, IterationBuffer& p_buffer) {
+    render(p_viewport, p_kernel, p_buffer, {{0, 0, p_buffer.getWidth(), p_buffer.getHeight()}});
+}
+
+void CpuRenderer::render(const Viewport& p_viewport,
+                         IEscapeTimeKernel& p_kernel,
+                         IterationBuffer& p_buffer,
+                         const std::vector<Tile>& p_regions) {
+    std::vector<Tile> tiles;
+    for (const Tile& region : p_regions) {
+        for (Tile tile : TileScheduler::splitIntoTiles(region.width, region.height, _tileSize)) {
+            tile.x += region.x;
+            tile.y += region.y;
+            tiles.push_back(tile);
+        }
+    }
+
+    if (_subdivision == Subdivision::Off) {
+        _scheduler.run(tiles,
+                       [&](const Tile& p_tile, unsigned) { p_kernel.renderTile(p_viewport, p_tile, p_buffer); });
+        return;
+    }
+
+    _scheduler.run(tiles, [&](const Tile& p_tile, unsigned) {
+        // Bottom and top row, then the columns between them
+        const int right = p_tile.x + p_tile.width - 1;
+        const int top = p_tile.y + p_tile.height - 1;
+        computeIfNotEmpty(p_viewport, p_kernel, p_buffer, {p_tile.x, p_tile.y, p_tile.width, 1});
+        if (top > p_tile.y) computeIfNotEmpty(p_viewport, p_kernel, p_buffer, {p_tile.x, top, p_tile.width, 1});
+        computeIfNotEmpty(p_viewport, p_kernel, p_buffer, {p_tile.x, p_tile.y + 1, 1, p_tile.height - 2});
+        if (right > p_tile.x) {
+            computeIfNotEmpty(p_viewport, p_kernel, p_buffer, {right, p_tile.y + 1, 1, p_tile.height - 2});
+        }
+
+        uint64_t filledPixels = 0;
+        subdivide(p_viewport, p_kernel, p_buffer, p_tile, filledPixels);
+        _filledPixels += filledPixels;
+    });
+}
+
+void CpuRenderer::subdivide(const Viewport& p_viewport,
+                            IEscapeTimeKernel& p_kernel,
+                            IterationBuffer& p_buffer,
+                            const Tile& p_rectangle,
+                            uint64_t& p_filledPixels) const {
+    const Tile inside = {p_rectangle.x + 1, p_rectangle.y + 1, p_rectangle.width - 2, p_rectangle.height - 2};
+    if (inside.width <= 0 || inside.height <= 0) return;
+
+    const uint32_t interior = static_cast<uint32_t>(std::max(p_viewport.maxIterations, 0));
+    const Border border = scanBorder(p_buffer, p_rectangle, interior);
+    if (border.uniform && (_subdivision == Subdivision::Uniform || border.value == interior)) {
+        for (int y = inside.y; y < inside.y + inside.height; y++) {
+            std::fill_n(&p_buffer.at(inside.x, y), inside.width, border.value);
+        }
+        p_filledPixels += static_cast<uint64_t>(inside.width) * inside.height;
+        return;
+    }
+
+    // Every split costs narrow kernel calls, which keep few SIMD lanes busy. Without interior on the border, only a
+    // small island of the set inside could be filled, it's cheaper to compute the rectangle at once.
+    if (inside.width < minSubdivisionSize || inside.height < minSubdivisionSize ||
+        (_subdivision == Subdivision::Interior && !border.touchesInterior)) {
+        p_kernel.renderTile(p_viewport, inside, p_buffer);
+        return;
+    }
+
+    // The middle row and column become the shared borders of the four quarters
+    const int middleX = p_rectangle.x + p_rectangle.width / 2;
+    const int middleY = p_rectangle.y + p_rectangle.height / 2;
+    const int right = p_rectangle.x + p_rectangle.width - 1;
+    const int top = p_rectangle.y + p_rectangle.height - 1;
+    computeIfNotEmpty(p_viewport, p_kernel, p_buffer, {inside.x, middleY, inside.width, 1});
+    computeIfNotEmpty(p_viewport, p_kernel, p_buffer, {middleX, inside.y, 1, middleY - inside.y});
+    computeIfNotEmpty(p_viewport, p_kernel, p_buffer, {middleX, middleY + 1, 1, top - middleY - 1});
+
+    subdivide(p_viewport, p_kernel, p_buffer,
+              {p_rectangle.x, p_rectangle.y, middleX - p_rectangle.x + 1, middleY - p_rectangle.y + 1},
+              p_filledPixels);
+    subdivide(p_viewport, p_kernel, p_buffer,
+              {middleX, p_rectangle.y, right - middleX + 1, middleY - p_rectangle.y + 1}, p_filledPixels);
+    subdivide(p_viewport, p_kernel, p_buffer,
+              {p_rectangle.x, middleY, middleX - p_rectangle.x + 1, top - middleY + 1}, p_filledPixels);
+    subdivide(p_viewport, p_kernel, p_buffer, {middleX, middleY, right - middleX + 1, top - middleY + 1},
+              p_filledPixels);
+}
@@ -0,0 +1,80 @@
+#include <cpu/DoubleDoubleKernel.hpp>
+#include <cpu/MandelbrotKernel.hpp>
+#include <cpu/PrecisionTier.hpp>
+
+#include <algorithm>
+
+void DoubleDoubleKernel::renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) {
+    const int width = p_buffer.getWidth();
+    const int height = p_buffer.getHeight();
+    const double pixelSize = p_viewport.getPixelSize(width);
+    const DoubleDouble centerReal(p_viewport.center.first, p_viewport.centerLow.first);
+    const DoubleDouble centerImaginary(p_viewport.center.second, p_viewport.centerLow.second);
+    const uint32_t interior = static_cast<uint32_t>(std::max(p_viewport.maxIterations, 0));
+    const double tolerance =
+        p_viewport.periodicityCheck ? getPeriodicityTolerance(PrecisionTier::DoubleDouble, pixelSize) : 0.0;
+    uint64_t periodicPixels = 0;
+
+    for (int y = p_tile.y; y < p_tile.y + p_tile.height; y++) {
+        const DoubleDouble imaginary = centerImaginary + DoubleDouble((y + 0.5 - height / 2.0) * pixelSize);
+        for (int x = p_tile.x; x < p_tile.x + p_tile.width; x++) {
+            const DoubleDouble real = centerReal + DoubleDouble((x + 0.5 - width / 2.0) * pixelSize);
+            p_buffer.at(x, y) = p_viewport.interiorCheck && isInMainCardioidOrBulb(real, imaginary)
+                                    ? interior
+                                    : iterate(real, imaginary, p_viewport.maxIterations, tolerance, periodicPixels);
+        }
+    }
+    _periodicPixels += periodicPixels;
+}
+
+uint32_t DoubleDoubleKernel::iterate(const DoubleDouble& p_real,
+                                     const DoubleDouble& p_imaginary,
+                                     int p_maxIterations,
+                                     double p_tolerance,
+                                     uint64_t& p_periodicPixels) {
+    DoubleDouble zReal;
+    DoubleDouble zImaginary;
+
+    // Brent's cycle detection, see MandelbrotKernel::iterate
+    const double tolerance2 = p_tolerance * p_tolerance;
+    DoubleDouble savedReal = 1e100;
+    DoubleDouble savedImaginary = 1e100;
+    int checkpoint = MandelbrotKernel::firstPeriodicityCheckpoint;
+    int period = MandelbrotKernel::firstPeriodicityCheckpoint;
+
+    int i;
+    for (i = 0; i < p_maxIterations; i++) {
+        const DoubleDouble zReal2 = zReal * zReal;
+        const DoubleDouble zImaginary2 = zImaginary * zImaginary;
+        if (zReal2.high + zImaginary2.high > 4.0) break;
+
+        if (p_tolerance > 0.0) {
+            const double differenceReal = (zReal - savedReal).high;
+            const double differenceImaginary = (zImaginary - savedImaginary).high;
+            if (differenceReal * differenceReal + differenceImaginary * differenceImaginary < tolerance2) {
+                p_periodicPixels++;
+                return static_cast<uint32_t>(p_maxIterations);
+            }
+            if (i >= checkpoint) {
+                savedReal = zReal;
+                savedImaginary = zImaginary;
+                period *= 2;
+                checkpoint = i + period;
+            }
+        }
+
+        zImaginary = (zReal * zImaginary).twice() + p_imaginary;
+        zReal = zReal2 - zImaginary2 + p_real;
+    }
+    return static_cast<uint32_t>(i);
+}
+
+bool DoubleDoubleKernel::isInMainCardioidOrBulb(const DoubleDouble& p_real, const DoubleDouble& p_imaginary) {
+    const DoubleDouble real = p_real - DoubleDouble(0.25);
+    const DoubleDouble imaginary2 = p_imaginary * p_imaginary;
+    const DoubleDouble q = real * real + imaginary2;
+    if ((q * (q + real) - imaginary2 * DoubleDouble(0.25)).high < 0.0) return true;
+
+    const DoubleDouble bulbReal = p_real + DoubleDouble(1.0);
+    return (bulbReal * bulbReal + imaginary2 - DoubleDouble(0.0625)).high < 0.0;
+}
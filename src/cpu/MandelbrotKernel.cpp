@@ -0,0 +1,68 @@
+#include <cpu/MandelbrotKernel.hpp>
+#include <cpu/PrecisionTier.hpp>
+
+#include <algorithm>
+
+void MandelbrotKernel::renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) {
+    const int width = p_buffer.getWidth();
+    const int height = p_buffer.getHeight();
+    const uint32_t interior = static_cast<uint32_t>(std::max(p_viewport.maxIterations, 0));
+    const double tolerance = p_viewport.periodicityCheck
+                                 ? getPeriodicityTolerance(PrecisionTier::Double, p_viewport.getPixelSize(width))
+                                 : 0.0;
+    uint64_t periodicPixels = 0;
+
+    for (int y = p_tile.y; y < p_tile.y + p_tile.height; y++) {
+        const double imaginary = p_viewport.pixelToImaginary(y, width, height);
+        for (int x = p_tile.x; x < p_tile.x + p_tile.width; x++) {
+            const double real = p_viewport.pixelToReal(x, width);
+            p_buffer.at(x, y) = p_viewport.interiorCheck && isInMainCardioidOrBulb(real, imaginary)
+                                    ? interior
+                                    : iterate(real, imaginary, p_viewport.maxIterations, tolerance, periodicPixels);
+        }
+    }
+    _periodicPixels += periodicPixels;
+}
+
+uint32_t MandelbrotKernel::iterate(double p_real,
+                                   double p_imaginary,
+                                   int p_maxIterations,
+                                   double p_tolerance,
+                                   uint64_t& p_periodicPixels) {
+    double zReal = 0.0;
+    double zImaginary = 0.0;
+
+    // Nothing is saved before the first checkpoint, the far away value never compares equal
+    const double tolerance2 = p_tolerance * p_tolerance;
+    double savedReal = 1e100;
+    double savedImaginary = 1e100;
+    int checkpoint = MandelbrotKernel::firstPeriodicityCheckpoint;
+    int period = MandelbrotKernel::firstPeriodicityCheckpoint;
+
+    int i;
+    for (i = 0; i < p_maxIterations; i++) {
+        const double zReal2 = zReal * zReal;
+        const double zImaginary2 = zImaginary * zImaginary;
+        if (zReal2 + zImaginary2 > 4.0) break;
+
+        // Same order as the SIMD loop (see runCompactingEscapeLoop): compare first, then save
+        if (p_tolerance > 0.0) {
+            const double differenceReal = zReal - savedReal;
+            const double differenceImaginary = zImaginary - savedImaginary;
+            if (differenceReal * differenceReal + differenceImaginary * differenceImaginary < tolerance2) {
+                p_periodicPixels++;
+                return static_cast<uint32_t>(p_maxIterations);
+            }
+            if (i >= checkpoint) {
+                savedReal = zReal;
+                savedImaginary = zImaginary;
+                period *= 2;
+                checkpoint = i + period;
+            }
+        }
+
+        zImaginary = 2.0 * zReal * zImaginary + p_imaginary;
+        zReal = zReal2 - zImaginary2 + p_real;
+    }
+    return static_cast<uint32_t>(i);
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cpu/SimdMandelbrotKernel.hpp>
+
+/**
+ * Lane-compacting escape-time loop, shared by the SSE2, AVX2 and AVX-512 translation units.
+ *
+ * Ops wraps the intrinsics of one instruction set and must be defined in an anonymous namespace of the including
+ * translation unit, so every instantiation stays local to the file compiled with the matching flags.
+ *
+ * Every lane holds its own pixel. Lanes are checked in the same order as MandelbrotKernel::iterate (escape test
+ * before the update), finished lanes store their iteration count and are immediately refilled with the next pixel.
+ * Pixels inside of the main cardioid or the period-2 bulb are written directly while refilling (see
+ * SimdTileJob::interiorCheck).
+ *
+ * With Periodicity, every lane runs its own Brent schedule (see MandelbrotKernel::iterate). The saves are blended into
+ * the vectors, the loop isn't left for them: a scalar countdown to the nearest checkpoint of all lanes decides, when
+ * that's needed.
+ */
+template <typename Ops, bool Periodicity>
+inline void runCompactingEscapeLoop(const SimdTileJob& p_job) {
+    using Vec = typename Ops::Vec;
+    constexpr int lanes = Ops::lanes;
+
+    const int pixelCount = p_job.width * p_job.height;
+    if (pixelCount == 0) return;
+
+    if (p_job.maxIterations <= 0) {
+        for (int y = 0; y < p_job.height; y++) {
+            for (int x = 0; x < p_job.width; x++) p_job.output[(p_job.y + y) * p_job.stride + p_job.x + x] = 0;
+        }
+        return;
+    }
+
+    alignas(64) double zReal[lanes], zImaginary[lanes], cReal[lanes], cImaginary[lanes], iterations[lanes];
+    alignas(64) double savedReal[lanes], savedImaginary[lanes], checkpoint[lanes], period[lanes];
+    int pixel[lanes];
+    int nextPixel = 0;
+    int activeLanes = 0;
+    uint64_t periodicPixels = 0;
+
+    auto fillLane = [&](int p_lane) {
+        zReal[p_lane] = 0.0;
+        zImaginary[p_lane] = 0.0;
+        // Nothing saved yet (see MandelbrotKernel::iterate)
+        savedReal[p_lane] = 1e100;
+        savedImaginary[p_lane] = 1e100;
+        period[p_lane] = MandelbrotKernel::firstPeriodicityCheckpoint;
+        while (nextPixel < pixelCount) {
+            const int x = p_job.x + nextPixel % p_job.width;
+            const int y = p_job.y + nextPixel / p_job.width;
+            const double real = p_job.centerReal + (x + 0.5 - p_job.halfWidth) * p_job.pixelSize;
+            const double imaginary = p_job.centerImaginary + (y + 0.5 - p_job.halfHeight) * p_job.pixelSize;
+
+            // Same test as MandelbrotKernel::isInMainCardioidOrBulb, interior pixels never occupy a lane
+            if (p_job.interiorCheck) {
+                const double shifted = real - 0.25;
+                const double imaginary2 = imaginary * imaginary;
+                const double q = shifted * shifted + imaginary2;
+                if (q * (q + shifted) < 0.25 * imaginary2 || (real + 1.0) * (real + 1.0) + imaginary2 < 0.0625) {
+                    p_job.output[y * p_job.stride + x] = static_cast<uint32_t>(p_job.maxIterations);
+                    nextPixel++;
+                    continue;
+                }
+            }
+
+            cReal[p_lane] = real;
+            cImaginary[p_lane] = imaginary;
+            iterations[p_lane] = 0.0;
+            checkpoint[p_lane] = MandelbrotKernel::firstPeriodicityCheckpoint;
+            pixel[p_lane] = nextPixel++;
+            activeLanes++;
+            return;
+        }
+
+        // Idle lane: c = 0 never escapes and the counter never reaches the limit or a checkpoint
+        cReal[p_lane] = 0.0;
+        cImaginary[p_lane] = 0.0;
+        iterations[p_lane] = -1e300;
+        checkpoint[p_lane] = 1e300;
+        pixel[p_lane] = -1;
+    };
+
+    for (int lane = 0; lane < lanes; lane++) fillLane(lane);
+
+    Vec zr = Ops::load(zReal), zi = Ops::load(zImaginary);
+    Vec cr = Ops::load(cReal), ci = Ops::load(cImaginary);
+    Vec it = Ops::load(iterations);
+    Vec sr = Ops::load(savedReal), si = Ops::load(savedImaginary);
+    Vec cp = Ops::load(checkpoint), pv = Ops::load(period);
+
+    const Vec four = Ops::set1(4.0);
+    const Vec two = Ops::set1(2.0);
+    const Vec one = Ops::set1(1.0);
+    const Vec maxIterations = Ops::set1(static_cast<double>(p_job.maxIterations));
+    const Vec tolerance2 = Ops::set1(p_job.periodicityTolerance * p_job.periodicityTolerance);
+
+    // All lanes advance together, so the next checkpoint of any lane is a plain countdown. Until a lane has passed
+    // its first checkpoint, there's nothing to compare to.
+    alignas(64) double remaining[lanes];
+    bool comparing = false;
+    auto getStepsToCheckpoint = [&]() {
+        Ops::store(remaining, Ops::sub(cp, it));
+        Ops::store(period, pv);
+        double steps = remaining[0];
+        comparing = false;
+        for (int lane = 0; lane < lanes; lane++) {
+            // No std::min, see SimdTileJob
+            steps = remaining[lane] < steps ? remaining[lane] : steps;
+            comparing |= period[lane] > MandelbrotKernel::firstPeriodicityCheckpoint;
+        }
+        return steps;
+    };
+    double stepsToCheckpoint = getStepsToCheckpoint();
+
+    while (activeLanes > 0) {
+        Vec zr2 = Ops::mul(zr, zr);
+        Vec zi2 = Ops::mul(zi, zi);
+
+        const unsigned escaped =
+            Ops::greaterMask(Ops::add(zr2, zi2), four) | Ops::greaterEqualMask(it, maxIterations);
+        unsigned periodic = 0;
+        if constexpr (Periodicity) {
+            if (comparing) {
+                const Vec differenceReal = Ops::sub(zr, sr);
+                const Vec differenceImaginary = Ops::sub(zi, si);
+                periodic = Ops::greaterMask(tolerance2, Ops::add(Ops::mul(differenceReal, differenceReal),
+                                                                 Ops::mul(differenceImaginary, differenceImaginary)));
+            }
+
+            // Lanes at their checkpoint save z and double their window, cp is compared last
+            if (stepsToCheckpoint <= 0.0) {
+                const Vec doubled = Ops::add(pv, pv);
+                sr = Ops::selectGreaterEqual(it, cp, zr, sr);
+                si = Ops::selectGreaterEqual(it, cp, zi, si);
+                pv = Ops::selectGreaterEqual(it, cp, doubled, pv);
+                cp = Ops::selectGreaterEqual(it, cp, Ops::add(it, doubled), cp);
+                stepsToCheckpoint = getStepsToCheckpoint();
+            }
+            stepsToCheckpoint--;
+        }
+
+        if (escaped | periodic) {
+            Ops::store(zReal, zr);
+            Ops::store(zImaginary, zi);
+            Ops::store(cReal, cr);
+            Ops::store(cImaginary, ci);
+            Ops::store(iterations, it);
+            if constexpr (Periodicity) {
+                Ops::store(savedReal, sr);
+                Ops::store(savedImaginary, si);
+                Ops::store(checkpoint, cp);
+                Ops::store(period, pv);
+            }
+
+            for (int lane = 0; lane < lanes; lane++) {
+                const unsigned bit = 1u << lane;
+                if (!((escaped | periodic) & bit) || pixel[lane] < 0) continue;
+
+                // Escape and limit before the periodicity, same as MandelbrotKernel::iterate
+                const int x = p_job.x + pixel[lane] % p_job.width;
+                const int y = p_job.y + pixel[lane] / p_job.width;
+                if (escaped & bit) {
+                    p_job.output[y * p_job.stride + x] = static_cast<uint32_t>(iterations[lane]);
+                } else {
+                    p_job.output[y * p_job.stride + x] = static_cast<uint32_t>(p_job.maxIterations);
+                    periodicPixels++;
+                }
+                activeLanes--;
+                fillLane(lane);
+            }
+
+            zr = Ops::load(zReal);
+            zi = Ops::load(zImaginary);
+            cr = Ops::load(cReal);
+            ci = Ops::load(cImaginary);
+            it = Ops::load(iterations);
+            if constexpr (Periodicity) {
+                sr = Ops::load(savedReal);
+                si = Ops::load(savedImaginary);
+                cp = Ops::load(checkpoint);
+                pv = Ops::load(period);
+                // The iteration below still advances every lane
+                stepsToCheckpoint = getStepsToCheckpoint() - 1.0;
+            }
+            zr2 = Ops::mul(zr, zr);
+            zi2 = Ops::mul(zi, zi);
+        }
+
+        zi = Ops::add(Ops::mul(Ops::mul(two, zr), zi), ci);
+        zr = Ops::add(Ops::sub(zr2, zi2), cr);
+        it = Ops::add(it, one);
+    }
+    *p_job.periodicPixels += periodicPixels;
+}
+
+/**
+ * Entry point of the translation units, selects the loop with or without periodicity detection.
+ */
+template <typename Ops>
+inline void runCompactingEscapeLoop(const SimdTileJob& p_job) {
+    if (p_job.periodicityTolerance > 0.0) {
+        runCompactingEscapeLoop<Ops, true>(p_job);
+    } else {
+        runCompactingEscapeLoop<Ops, false>(p_job);
+    }
+}
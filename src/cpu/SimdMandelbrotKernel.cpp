@@ -0,0 +1,38 @@
+#include <cpu/PrecisionTier.hpp>
+#include <cpu/SimdMandelbrotKernel.hpp>
+
+SimdMandelbrotKernel::SimdMandelbrotKernel(SimdLevel p_level) {
+    const SimdLevel supported = detectSimdLevel();
+    _level = static_cast<int>(p_level) <= static_cast<int>(supported) ? p_level : supported;
+}
+
+void SimdMandelbrotKernel::renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) {
+    const double pixelSize = p_viewport.getPixelSize(p_buffer.getWidth());
+    uint64_t periodicPixels = 0;
+    const SimdTileJob job = {p_viewport.center.first,
+                             p_viewport.center.second,
+                             pixelSize,
+                             p_buffer.getWidth() / 2.0,
+                             p_buffer.getHeight() / 2.0,
+                             p_tile.x,
+                             p_tile.y,
+                             p_tile.width,
+                             p_tile.height,
+                             p_viewport.maxIterations,
+                             p_viewport.interiorCheck,
+                             p_viewport.periodicityCheck ? getPeriodicityTolerance(PrecisionTier::Double, pixelSize)
+                                                         : 0.0,
+                             p_buffer.getData(),
+                             p_buffer.getWidth(),
+                             &periodicPixels};
+
+    switch (_level) {
+#if defined(CPU_RENDERER_X86_SIMD)
+        case SimdLevel::SSE2: renderTileSse2(job); break;
+        case SimdLevel::AVX2: renderTileAvx2(job); break;
+        case SimdLevel::AVX512: renderTileAvx512(job); break;
+#endif
+        default: _fallback.renderTile(p_viewport, p_tile, p_buffer); return;
+    }
+    _periodicPixels += periodicPixels;
+}
@@ -0,0 +1,29 @@
+#include "SimdEscapeLoop.hpp"
+
+#include <immintrin.h>
+
+namespace {
+    struct Avx2Ops {
+            using Vec = __m256d;
+            static constexpr int lanes = 4;
+
+            static Vec load(const double* p_values) { return _mm256_load_pd(p_values); }
+            static void store(double* p_values, Vec p_vec) { _mm256_store_pd(p_values, p_vec); }
+            static Vec set1(double p_value) { return _mm256_set1_pd(p_value); }
+            static Vec add(Vec p_a, Vec p_b) { return _mm256_add_pd(p_a, p_b); }
+            static Vec sub(Vec p_a, Vec p_b) { return _mm256_sub_pd(p_a, p_b); }
+            static Vec mul(Vec p_a, Vec p_b) { return _mm256_mul_pd(p_a, p_b); }
+            static unsigned greaterMask(Vec p_a, Vec p_b) {
+                return _mm256_movemask_pd(_mm256_cmp_pd(p_a, p_b, _CMP_GT_OQ));
+            }
+            static unsigned greaterEqualMask(Vec p_a, Vec p_b) {
+                return _mm256_movemask_pd(_mm256_cmp_pd(p_a, p_b, _CMP_GE_OQ));
+            }
+            // p_a >= p_b ? p_x : p_y per lane
+            static Vec selectGreaterEqual(Vec p_a, Vec p_b, Vec p_x, Vec p_y) {
+                return _mm256_blendv_pd(p_y, p_x, _mm256_cmp_pd(p_a, p_b, _CMP_GE_OQ));
+            }
+    };
+}
+
+void SimdMandelbrotKernel::renderTileAvx2(const SimdTileJob& p_job) { runCompactingEscapeLoop<Avx2Ops>(p_job); }
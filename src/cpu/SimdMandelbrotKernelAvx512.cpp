@@ -0,0 +1,25 @@
+#include "SimdEscapeLoop.hpp"
+
+#include <immintrin.h>
+
+namespace {
+    struct Avx512Ops {
+            using Vec = __m512d;
+            static constexpr int lanes = 8;
+
+            static Vec load(const double* p_values) { return _mm512_load_pd(p_values); }
+            static void store(double* p_values, Vec p_vec) { _mm512_store_pd(p_values, p_vec); }
+            static Vec set1(double p_value) { return _mm512_set1_pd(p_value); }
+            static Vec add(Vec p_a, Vec p_b) { return _mm512_add_pd(p_a, p_b); }
+            static Vec sub(Vec p_a, Vec p_b) { return _mm512_sub_pd(p_a, p_b); }
+            static Vec mul(Vec p_a, Vec p_b) { return _mm512_mul_pd(p_a, p_b); }
+            static unsigned greaterMask(Vec p_a, Vec p_b) { return _mm512_cmp_pd_mask(p_a, p_b, _CMP_GT_OQ); }
+            static unsigned greaterEqualMask(Vec p_a, Vec p_b) { return _mm512_cmp_pd_mask(p_a, p_b, _CMP_GE_OQ); }
+            // p_a >= p_b ? p_x : p_y per lane
+            static Vec selectGreaterEqual(Vec p_a, Vec p_b, Vec p_x, Vec p_y) {
+                return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(p_a, p_b, _CMP_GE_OQ), p_y, p_x);
+            }
+    };
+}
+
+void SimdMandelbrotKernel::renderTileAvx512(const SimdTileJob& p_job) { runCompactingEscapeLoop<Avx512Ops>(p_job); }
@@ -0,0 +1,26 @@
+#include "SimdEscapeLoop.hpp"
+
+#include <emmintrin.h>
+
+namespace {
+    struct Sse2Ops {
+            using Vec = __m128d;
+            static constexpr int lanes = 2;
+
+            static Vec load(const double* p_values) { return _mm_load_pd(p_values); }
+            static void store(double* p_values, Vec p_vec) { _mm_store_pd(p_values, p_vec); }
+            static Vec set1(double p_value) { return _mm_set1_pd(p_value); }
+            static Vec add(Vec p_a, Vec p_b) { return _mm_add_pd(p_a, p_b); }
+            static Vec sub(Vec p_a, Vec p_b) { return _mm_sub_pd(p_a, p_b); }
+            static Vec mul(Vec p_a, Vec p_b) { return _mm_mul_pd(p_a, p_b); }
+            static unsigned greaterMask(Vec p_a, Vec p_b) { return _mm_movemask_pd(_mm_cmpgt_pd(p_a, p_b)); }
+            static unsigned greaterEqualMask(Vec p_a, Vec p_b) { return _mm_movemask_pd(_mm_cmpge_pd(p_a, p_b)); }
+            // p_a >= p_b ? p_x : p_y per lane
+            static Vec selectGreaterEqual(Vec p_a, Vec p_b, Vec p_x, Vec p_y) {
+                const Vec mask = _mm_cmpge_pd(p_a, p_b);
+                return _mm_or_pd(_mm_and_pd(mask, p_x), _mm_andnot_pd(mask, p_y));
+            }
+    };
+}
+
+void SimdMandelbrotKernel::renderTileSse2(const SimdTileJob& p_job) { runCompactingEscapeLoop<Sse2Ops>(p_job); }
@@ -0,0 +1,174 @@
+#include <cpu/TileCache.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace {
+    // Floor division by the tile size (for negative sample indices as well)
+    int64_t tileOf(int64_t p_sample) {
+        return p_sample >= 0 ? p_sample / TileCache::TILE_SIZE : -((-p_sample - 1) / TileCache::TILE_SIZE) - 1;
+    }
+
+    // floor((high + low + offset) * 2^exponent): the index of the sample containing a point
+    int64_t sampleIndex(double p_high, double p_low, double p_offset, int p_exponent) {
+        const double high = std::ldexp(p_high, p_exponent);
+        const double base = std::floor(high);
+        const double rest = (high - base) + std::ldexp(p_low, p_exponent) + std::ldexp(p_offset, p_exponent);
+        return static_cast<int64_t>(base) + static_cast<int64_t>(std::floor(rest));
+    }
+
+    // p_index * 2^-exponent as an exact double-double
+    std::pair<double, double> toDoubleDouble(int64_t p_index, int p_exponent) {
+        const double high = static_cast<double>(p_index);
+        const double low = static_cast<double>(p_index - static_cast<int64_t>(high));
+        return {std::ldexp(high, -p_exponent), std::ldexp(low, -p_exponent)};
+    }
+}
+
+void TileCache::setMemoryBudget(size_t p_memoryBudget) {
+    _memoryBudget = p_memoryBudget;
+    evict();
+}
+
+int TileCache::levelFor(double p_pixelSize) {
+    if (!(p_pixelSize > 0.0)) return -1;
+
+    // Samples of level L are 2^(-6 - L) apart, use the coarsest level, which still resolves the pixels
+    const int level = std::max(0, -6 - std::ilogb(p_pixelSize));
+    return level <= MAX_LEVEL ? level : -1;
+}
+
+bool TileCache::lookup(const Viewport& p_viewport, IterationBuffer& p_buffer, const std::vector<Tile>& p_regions) {
+    return assemble(p_viewport, nullptr, nullptr, p_buffer, p_regions);
+}
+
+void TileCache::render(const Viewport& p_viewport,
+                       CpuRenderer& p_renderer,
+                       const KernelSelector& p_selectKernel,
+                       IterationBuffer& p_buffer,
+                       const std::vector<Tile>& p_regions) {
+    assemble(p_viewport, &p_renderer, &p_selectKernel, p_buffer, p_regions);
+}
+
+void TileCache::clear() {
+    _entries.clear();
+    _index.clear();
+}
+
+bool TileCache::assemble(const Viewport& p_viewport,
+                         CpuRenderer* p_renderer,
+                         const KernelSelector* p_selectKernel,
+                         IterationBuffer& p_buffer,
+                         const std::vector<Tile>& p_regions) {
+    const int width = p_buffer.getWidth();
+    const int height = p_buffer.getHeight();
+    const double pixelSize = p_viewport.getPixelSize(width);
+    const int level = levelFor(pixelSize);
+    if (level < 0) return false;
+
+    // Samples per unit are 2^exponent. Tiles are computed with a rounded up limit, so small changes of the
+    // iteration count still hit the cache (the shader clamps to the exact limit).
+    const int exponent = 6 + level;
+    const int maxIterations = (p_viewport.maxIterations + 63) / 64 * 64;
+
+    // Sample index of every column and row, the frame is separable
+    std::vector<int64_t> columns(width);
+    std::vector<int64_t> rows(height);
+    for (int x = 0; x < width; x++) {
+        columns[x] = sampleIndex(p_viewport.center.first, p_viewport.centerLow.first,
+                                 (x + 0.5 - width / 2.0) * pixelSize, exponent);
+    }
+    for (int y = 0; y < height; y++) {
+        rows[y] = sampleIndex(p_viewport.center.second, p_viewport.centerLow.second,
+                              (y + 0.5 - height / 2.0) * pixelSize, exponent);
+    }
+
+    // Tiles touched by the regions (the indices grow monotonically with x and y)
+    std::vector<TileKey> keys;
+    for (const Tile& region : p_regions) {
+        if (region.width <= 0 || region.height <= 0) continue;
+        for (int64_t tileY = tileOf(rows[region.y]); tileY <= tileOf(rows[region.y + region.height - 1]); tileY++) {
+            for (int64_t tileX = tileOf(columns[region.x]); tileX <= tileOf(columns[region.x + region.width - 1]);
+                 tileX++) {
+                const TileKey key = {level, tileX, tileY, maxIterations};
+                if (std::find(keys.begin(), keys.end(), key) == keys.end()) { keys.push_back(key); }
+            }
+        }
+    }
+
+    // Samples of each tile: in memory, mapped from the store, or computed below
+    std::vector<const uint32_t*> samples(keys.size(), nullptr);
+    std::vector<TileKey> missing;
+    for (size_t i = 0; i < keys.size(); i++) {
+        const auto found = _index.find(keys[i]);
+        if (found != _index.end()) {
+            samples[i] = found->second->samples.getData();
+        } else if (_store) {
+            samples[i] = _store->find(keys[i]);
+        }
+        if (!samples[i]) { missing.push_back(keys[i]); }
+    }
+    if (!missing.empty() && !p_renderer) return false;
+
+    for (size_t i = 0; i < keys.size(); i++) {
+        const auto found = _index.find(keys[i]);
+        if (found != _index.end()) {
+            _entries.splice(_entries.begin(), _entries, found->second);
+            _hits++;
+        } else if (samples[i]) {
+            _storeHits++;
+        }
+    }
+
+    for (const TileKey& key : missing) {
+        // Sample i of the tile lies at (key.x * TILE_SIZE + i + 0.5) * 2^-exponent
+        const std::pair<double, double> centerReal = toDoubleDouble(key.x * TILE_SIZE + TILE_SIZE / 2, exponent);
+        const std::pair<double, double> centerImaginary = toDoubleDouble(key.y * TILE_SIZE + TILE_SIZE / 2, exponent);
+        const Viewport viewport = {{centerReal.first, centerImaginary.first},
+                                   FloatExp(std::ldexp(static_cast<double>(TILE_SIZE), -exponent)),
+                                   key.maxIterations,
+                                   {centerReal.second, centerImaginary.second},
+                                   p_viewport.interiorCheck,
+                                   p_viewport.periodicityCheck};
+
+        _entries.push_front({key, IterationBuffer(TILE_SIZE, TILE_SIZE)});
+        p_renderer->render(viewport, (*p_selectKernel)(viewport), _entries.front().samples);
+        _index[key] = _entries.begin();
+        _misses++;
+
+        samples[std::find(keys.begin(), keys.end(), key) - keys.begin()] = _entries.front().samples.getData();
+        if (_store) { _store->append(key, _entries.front().samples.getData()); }
+    }
+
+    for (const Tile& region : p_regions) {
+        for (int y = region.y; y < region.y + region.height; y++) {
+            const int64_t tileY = tileOf(rows[y]);
+            const int sampleY = static_cast<int>(rows[y] - tileY * TILE_SIZE);
+
+            // Consecutive pixels mostly share a tile
+            const uint32_t* row = nullptr;
+            int64_t currentTileX = 0;
+            for (int x = region.x; x < region.x + region.width; x++) {
+                const int64_t tileX = tileOf(columns[x]);
+                if (!row || tileX != currentTileX) {
+                    const TileKey key = {level, tileX, tileY, maxIterations};
+                    row = samples[std::find(keys.begin(), keys.end(), key) - keys.begin()] + sampleY * TILE_SIZE;
+                    currentTileX = tileX;
+                }
+                p_buffer.at(x, y) = row[columns[x] - tileX * TILE_SIZE];
+            }
+        }
+    }
+
+    evict();
+    return true;
+}
+
+void TileCache::evict() {
+    const size_t tileBytes = TILE_SIZE * TILE_SIZE * sizeof(uint32_t);
+    while (!_entries.empty() && _entries.size() * tileBytes > _memoryBudget) {
+        _index.erase(_entries.back().key);
+        _entries.pop_back();
+    }
+}
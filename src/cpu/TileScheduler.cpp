@@ -0,0 +1,109 @@
+#include <cpu/TileScheduler.hpp>
+
+#include <algorithm>
+
+TileScheduler::TileScheduler(unsigned p_threadCount) {
+    const unsigned threadCount = p_threadCount ? p_threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < threadCount; i++) { _queues.emplace_back(std::make_unique<WorkerQueue>()); }
+    for (unsigned i = 0; i < threadCount; i++) { _threads.emplace_back(&TileScheduler::workerLoop, this, i); }
+}
+
+TileScheduler::~TileScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wakeCondition.notify_all();
+
+    for (std::thread& thread : _threads) { thread.join(); }
+}
+
+void TileScheduler::run(const std::vector<Tile>& p_tiles, const Task& p_task) {
+    if (p_tiles.empty()) return;
+
+    std::lock_guard<std::mutex> runLock(_runMutex);
+
+    // Hand out contiguous blocks, so each worker starts on neighbouring tiles. Imbalance is fixed by stealing.
+    const size_t workerCount = _queues.size();
+    for (size_t i = 0; i < p_tiles.size(); i++) {
+        WorkerQueue& queue = *_queues[i * workerCount / p_tiles.size()];
+        std::lock_guard<std::mutex> queueLock(queue.mutex);
+        queue.tiles.push_back(p_tiles[i]);
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _error = nullptr;
+    _task = &p_task;
+    _activeWorkers = static_cast<unsigned>(workerCount);
+    _generation++;
+    _wakeCondition.notify_all();
+
+    _doneCondition.wait(lock, [this]() { return _activeWorkers == 0; });
+    _task = nullptr;
+
+    if (_error) { std::rethrow_exception(_error); }
+}
+
+std::vector<Tile> TileScheduler::splitIntoTiles(int p_width, int p_height, int p_tileSize) {
+    std::vector<Tile> tiles;
+    for (int y = 0; y < p_height; y += p_tileSize) {
+        for (int x = 0; x < p_width; x += p_tileSize) {
+            tiles.push_back({x, y, std::min(p_tileSize, p_width - x), std::min(p_tileSize, p_height - y)});
+        }
+    }
+    return tiles;
+}
+
+void TileScheduler::workerLoop(unsigned p_index) {
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wakeCondition.wait(lock, [&]() { return _stopping || _generation != seenGeneration; });
+            if (_stopping) return;
+            seenGeneration = _generation;
+        }
+
+        // Tiles are only queued before a run starts, so once there is nothing left to steal, this worker is done.
+        // It sleeps on _wakeCondition while the others finish their last tiles, the last one wakes run().
+        Tile tile;
+        while (popTile(p_index, tile)) {
+            try {
+                (*_task)(tile, p_index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(_errorMutex);
+                if (!_error) _error = std::current_exception();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_activeWorkers == 0) _doneCondition.notify_one();
+    }
+}
+
+bool TileScheduler::popTile(unsigned p_index, Tile& p_tile) {
+    // Own queue first (LIFO, the most recently queued tile is the most likely to be cache-hot)
+    {
+        WorkerQueue& own = *_queues[p_index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tiles.empty()) {
+            p_tile = own.tiles.back();
+            own.tiles.pop_back();
+            return true;
+        }
+    }
+
+    // Steal from the opposite end of the other queues
+    for (size_t offset = 1; offset < _queues.size(); offset++) {
+        WorkerQueue& victim = *_queues[(p_index + offset) % _queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tiles.empty()) {
+            p_tile = victim.tiles.front();
+            victim.tiles.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
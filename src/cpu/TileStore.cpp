@@ -0,0 +1,218 @@
+#include <cpu/TileStore.hpp>
+#include <exception/TileStoreError.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char MAGIC[8] = {'G', 'L', 'F', 'X', 'T', 'I', 'L', 'E'};
+    constexpr uint32_t VERSION = 1;
+
+    // Native byte order, the files aren't meant to be moved between architectures
+    struct IndexHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t samplesPerTile;
+    };
+
+    struct IndexRecord {
+            int32_t level;
+            int32_t maxIterations;
+            int64_t x;
+            int64_t y;
+            uint64_t tile;
+    };
+
+    // Map p_length bytes of the file read-only, p_offset must be a multiple of the allocation granularity
+    const void* mapFile(const std::string& p_path, uint64_t p_offset, size_t p_length) {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(p_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return nullptr;
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) return nullptr;
+        const void* address = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(p_offset >> 32),
+                                            static_cast<DWORD>(p_offset & 0xFFFFFFFFu), p_length);
+        // The view keeps the mapping alive
+        CloseHandle(mapping);
+        return address;
+#else
+        const int file = open(p_path.c_str(), O_RDONLY);
+        if (file < 0) return nullptr;
+        void* address = mmap(nullptr, p_length, PROT_READ, MAP_SHARED, file, static_cast<off_t>(p_offset));
+        // The mapping keeps the file alive
+        close(file);
+        return address == MAP_FAILED ? nullptr : address;
+#endif
+    }
+
+    bool seekFile(std::FILE* p_file, uint64_t p_offset) {
+#if defined(_WIN32)
+        return _fseeki64(p_file, static_cast<__int64>(p_offset), SEEK_SET) == 0;
+#else
+        return fseeko(p_file, static_cast<off_t>(p_offset), SEEK_SET) == 0;
+#endif
+    }
+
+    void unmapFile(const void* p_address, size_t p_length) {
+#if defined(_WIN32)
+        (void)p_length;
+        UnmapViewOfFile(p_address);
+#else
+        munmap(const_cast<void*>(p_address), p_length);
+#endif
+    }
+}
+
+TileStore::TileStore(const std::string& p_directory, int p_samplesPerTile)
+    : _tileBytes(static_cast<size_t>(p_samplesPerTile) * sizeof(uint32_t)) {
+    namespace fs = std::filesystem;
+    std::error_code error;
+    fs::create_directories(p_directory, error);
+
+    const fs::path dataPath = fs::path(p_directory) / "tiles.dat";
+    const fs::path indexPath = fs::path(p_directory) / "tiles.idx";
+    _dataPath = dataPath.string();
+
+    // Drop a partially written tile at the end (the data is always complete before its index record)
+    if (fs::exists(dataPath)) {
+        const uint64_t dataSize = fs::file_size(dataPath);
+        _reservedTiles = dataSize / _tileBytes;
+        if (dataSize % _tileBytes != 0) { fs::resize_file(dataPath, _reservedTiles * _tileBytes); }
+    }
+
+    IndexHeader expectedHeader;
+    std::memcpy(expectedHeader.magic, MAGIC, sizeof(MAGIC));
+    expectedHeader.version = VERSION;
+    expectedHeader.samplesPerTile = static_cast<uint32_t>(p_samplesPerTile);
+    const bool indexExists = fs::exists(indexPath) && fs::file_size(indexPath) >= sizeof(IndexHeader);
+    if (indexExists) {
+        std::FILE* indexFile = std::fopen(indexPath.string().c_str(), "rb");
+        if (!indexFile) throw TileStoreError(indexPath.string(), "can't be opened");
+
+        IndexHeader header;
+        if (std::fread(&header, sizeof(header), 1, indexFile) != 1 ||
+            std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+            std::fclose(indexFile);
+            throw TileStoreError(indexPath.string(), "not a tile index");
+        }
+        if (header.samplesPerTile != expectedHeader.samplesPerTile) {
+            std::fclose(indexFile);
+            throw TileStoreError(indexPath.string(), "written for a different tile size");
+        }
+
+        // Records of tiles, which didn't make it into the data file, are dropped together with a partial record.
+        // New tiles go behind the last indexed one, a tile written without its record is overwritten.
+        uint64_t validRecords = 0;
+        IndexRecord record;
+        while (std::fread(&record, sizeof(record), 1, indexFile) == 1 && record.tile < _reservedTiles) {
+            _index[{record.level, record.x, record.y, record.maxIterations}] = record.tile;
+            _storedTiles = std::max(_storedTiles, record.tile + 1);
+            validRecords++;
+        }
+        std::fclose(indexFile);
+
+        const uint64_t indexSize = sizeof(IndexHeader) + validRecords * sizeof(IndexRecord);
+        if (fs::file_size(indexPath) != indexSize) { fs::resize_file(indexPath, indexSize); }
+    }
+
+    // Tiles are written at their position in the reserved space, not appended to the end of the file
+    if (!fs::exists(dataPath)) {
+        std::FILE* dataFile = std::fopen(_dataPath.c_str(), "wb");
+        if (dataFile) std::fclose(dataFile);
+    }
+    _dataFile = std::fopen(_dataPath.c_str(), "r+b");
+    _indexFile = std::fopen(indexPath.string().c_str(), indexExists ? "ab" : "wb");
+    if (!_dataFile || !_indexFile) {
+        if (_dataFile) std::fclose(_dataFile);
+        if (_indexFile) std::fclose(_indexFile);
+        throw TileStoreError(p_directory, "can't be opened for writing");
+    }
+    if (!indexExists) {
+        std::fwrite(&expectedHeader, sizeof(expectedHeader), 1, _indexFile);
+        std::fflush(_indexFile);
+    }
+
+    // Everything reserved so far in one segment
+    mapTail();
+}
+
+TileStore::~TileStore() {
+    for (const Segment& segment : _segments) { unmapFile(segment.samples, segment.tileCount * _tileBytes); }
+    std::fclose(_dataFile);
+    std::fclose(_indexFile);
+}
+
+const uint32_t* TileStore::find(const TileKey& p_key) {
+    const auto found = _index.find(p_key);
+    if (found == _index.end()) return nullptr;
+
+    const uint64_t tile = found->second;
+    if (tile >= _mappedTiles) {
+        mapTail();
+        if (tile >= _mappedTiles) return nullptr;
+    }
+
+    // Segments are ordered by their first tile, the last one starting at or before the tile covers it
+    const auto next =
+        std::upper_bound(_segments.begin(), _segments.end(), tile, [](uint64_t p_tile, const Segment& p_segment) {
+            return p_tile < p_segment.firstTile;
+        });
+    if (next == _segments.begin()) return nullptr;
+    const Segment& segment = *(next - 1);
+    return segment.samples + (tile - segment.firstTile) * (_tileBytes / sizeof(uint32_t));
+}
+
+void TileStore::append(const TileKey& p_key, const uint32_t* p_samples) {
+    if (_index.find(p_key) != _index.end()) return;
+
+    if (_storedTiles == _reservedTiles) reserve();
+
+    // The tile must be complete on disk before the index refers to it
+    const uint64_t tile = _storedTiles;
+    if (!seekFile(_dataFile, tile * _tileBytes) || std::fwrite(p_samples, _tileBytes, 1, _dataFile) != 1 ||
+        std::fflush(_dataFile) != 0) {
+        throw TileStoreError(_dataPath, "write failed");
+    }
+    // Occupied even if the index record fails, the following tiles must not be misplaced
+    _storedTiles++;
+
+    const IndexRecord record = {p_key.level, p_key.maxIterations, p_key.x, p_key.y, tile};
+    if (std::fwrite(&record, sizeof(record), 1, _indexFile) != 1 || std::fflush(_indexFile) != 0) {
+        throw TileStoreError(_dataPath, "index write failed");
+    }
+    _index[p_key] = tile;
+}
+
+void TileStore::mapTail() {
+    if (_reservedTiles == _mappedTiles) return;
+
+    // TileCache tiles are 256 KiB, so every tile offset is aligned to the page size / allocation granularity
+    const uint64_t tileCount = _reservedTiles - _mappedTiles;
+    const void* address = mapFile(_dataPath, _mappedTiles * _tileBytes, tileCount * _tileBytes);
+    if (!address) return;
+
+    _segments.push_back({static_cast<const uint32_t*>(address), _mappedTiles, tileCount});
+    _mappedTiles = _reservedTiles;
+}
+
+void TileStore::reserve() {
+    // Doubling the file keeps the number of segments logarithmic in its size, no matter how finds and appends
+    // interleave (each segment covers everything reserved up to then)
+    const uint64_t reservedTiles = std::max(MIN_RESERVED_TILES, 2 * _reservedTiles);
+    if (std::fflush(_dataFile) != 0) throw TileStoreError(_dataPath, "write failed");
+    std::error_code error;
+    std::filesystem::resize_file(_dataPath, reservedTiles * _tileBytes, error);
+    if (error) throw TileStoreError(_dataPath, "can't be extended: " + error.message());
+    _reservedTiles = reservedTiles;
+}
@@ -0,0 +1,379 @@
+#include <image/Deflate.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <queue>
+
+namespace {
+    constexpr size_t WINDOW_SIZE = 32768;
+    // Matches are found via a hash of 4 bytes (DEFLATE would allow 3)
+    constexpr size_t MIN_MATCH = 4;
+    constexpr size_t MAX_MATCH = 258;
+    constexpr int HASH_BITS = 15;
+    constexpr size_t BLOCK_SYMBOLS = size_t(1) << 16;
+
+    constexpr int LITERAL_CODES = 286;
+    constexpr int DISTANCE_CODES = 30;
+    constexpr int LENGTH_CODES = 19;
+    constexpr int END_OF_BLOCK = 256;
+
+    constexpr uint16_t LENGTH_BASE[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                          31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                          2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    constexpr uint16_t DISTANCE_BASE[30] = {1,    2,    3,    4,    5,    7,    9,     13,    17,    25,
+                                            33,   49,   65,   97,   129,  193,  257,   385,   513,   769,
+                                            1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    constexpr uint8_t DISTANCE_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                            6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    // Transmission order of the code length code lengths
+    constexpr uint8_t LENGTH_ORDER[LENGTH_CODES] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    // A literal (distance 0) or a match
+    struct Symbol {
+            uint16_t value;
+            uint16_t distance;
+    };
+
+    class BitWriter {
+        public:
+            explicit BitWriter(std::vector<uint8_t>& p_out) : _out(p_out) {}
+
+            // DEFLATE packs bits starting at the least significant bit
+            void write(uint32_t p_bits, int p_count) {
+                _buffer |= static_cast<uint64_t>(p_bits) << _count;
+                _count += p_count;
+                while (_count >= 8) {
+                    _out.push_back(static_cast<uint8_t>(_buffer));
+                    _buffer >>= 8;
+                    _count -= 8;
+                }
+            }
+
+            void alignToByte() {
+                if (_count > 0) { _out.push_back(static_cast<uint8_t>(_buffer)); }
+                _buffer = 0;
+                _count = 0;
+            }
+
+        private:
+            std::vector<uint8_t>& _out;
+            uint64_t _buffer = 0;
+            int _count = 0;
+    };
+
+    inline uint32_t hash(const uint8_t* p_data) {
+        uint32_t value;
+        std::memcpy(&value, p_data, sizeof(value));
+        return (value * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    inline int lengthCode(int p_length) {
+        return static_cast<int>(std::upper_bound(LENGTH_BASE, LENGTH_BASE + 29, p_length) - LENGTH_BASE) - 1;
+    }
+
+    inline int distanceCode(int p_distance) {
+        return static_cast<int>(std::upper_bound(DISTANCE_BASE, DISTANCE_BASE + 30, p_distance) - DISTANCE_BASE) - 1;
+    }
+
+    // Huffman code lengths limited to p_maxBits: frequencies are flattened until the tree is shallow enough
+    void buildLengths(const uint32_t* p_frequencies, int p_count, int p_maxBits, uint8_t* p_lengths) {
+        std::vector<uint64_t> frequencies(p_frequencies, p_frequencies + p_count);
+        while (true) {
+            std::fill(p_lengths, p_lengths + p_count, 0);
+
+            using Node = std::pair<uint64_t, int>;
+            std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+            // Leaves are 0 ... p_count - 1, inner nodes follow
+            std::vector<int> parent(p_count, -1);
+            for (int symbol = 0; symbol < p_count; symbol++) {
+                if (frequencies[symbol] > 0) { queue.push({frequencies[symbol], symbol}); }
+            }
+            if (queue.size() == 1) {
+                p_lengths[queue.top().second] = 1;
+                return;
+            }
+            while (queue.size() > 1) {
+                const Node first = queue.top();
+                queue.pop();
+                const Node second = queue.top();
+                queue.pop();
+                const int node = static_cast<int>(parent.size());
+                parent.push_back(-1);
+                parent[first.second] = node;
+                parent[second.second] = node;
+                queue.push({first.first + second.first, node});
+            }
+
+            // Parents always have higher indices, so their depth is known when walking backwards
+            std::vector<int> depth(parent.size(), 0);
+            int maxDepth = 0;
+            for (int node = static_cast<int>(parent.size()) - 2; node >= 0; node--) {
+                if (parent[node] >= 0) { depth[node] = depth[parent[node]] + 1; }
+                if (node < p_count && frequencies[node] > 0) {
+                    p_lengths[node] = static_cast<uint8_t>(depth[node]);
+                    maxDepth = std::max(maxDepth, depth[node]);
+                }
+            }
+            if (maxDepth <= p_maxBits) return;
+
+            for (uint64_t& frequency : frequencies) {
+                if (frequency > 0) { frequency = std::max<uint64_t>(1, frequency >> 1); }
+            }
+        }
+    }
+
+    // Canonical codes, bit-reversed for the LSB first packing
+    void buildCodes(const uint8_t* p_lengths, int p_count, uint16_t* p_codes) {
+        int lengthCounts[16] = {};
+        for (int symbol = 0; symbol < p_count; symbol++) { lengthCounts[p_lengths[symbol]]++; }
+        lengthCounts[0] = 0;
+
+        int nextCode[16] = {};
+        for (int bits = 1, code = 0; bits < 16; bits++) {
+            code = (code + lengthCounts[bits - 1]) << 1;
+            nextCode[bits] = code;
+        }
+        for (int symbol = 0; symbol < p_count; symbol++) {
+            const int length = p_lengths[symbol];
+            if (length == 0) continue;
+            int code = nextCode[length]++;
+            int reversed = 0;
+            for (int bit = 0; bit < length; bit++) {
+                reversed = (reversed << 1) | (code & 1);
+                code >>= 1;
+            }
+            p_codes[symbol] = static_cast<uint16_t>(reversed);
+        }
+    }
+
+    // Run-length encoding of the code lengths (symbols 16: repeat, 17 / 18: zeros), extra bits in the upper byte
+    std::vector<uint32_t> encodeLengths(const uint8_t* p_lengths, int p_count) {
+        std::vector<uint32_t> symbols;
+        for (int i = 0; i < p_count;) {
+            const uint8_t length = p_lengths[i];
+            int run = 1;
+            while (i + run < p_count && p_lengths[i + run] == length) { run++; }
+            i += run;
+
+            if (length == 0) {
+                while (run >= 11) {
+                    const int repeat = std::min(run, 138);
+                    symbols.push_back(18 | (repeat - 11) << 8);
+                    run -= repeat;
+                }
+                if (run >= 3) {
+                    symbols.push_back(17 | (run - 3) << 8);
+                    run = 0;
+                }
+            } else {
+                symbols.push_back(length);
+                run--;
+                while (run >= 3) {
+                    const int repeat = std::min(run, 6);
+                    symbols.push_back(16 | (repeat - 3) << 8);
+                    run -= repeat;
+                }
+            }
+            for (; run > 0; run--) { symbols.push_back(length); }
+        }
+        return symbols;
+    }
+
+    void writeBlock(BitWriter& p_writer, const std::vector<Symbol>& p_symbols) {
+        uint32_t literalFrequencies[LITERAL_CODES] = {};
+        uint32_t distanceFrequencies[DISTANCE_CODES] = {};
+        for (const Symbol& symbol : p_symbols) {
+            if (symbol.distance == 0) {
+                literalFrequencies[symbol.value]++;
+            } else {
+                literalFrequencies[257 + lengthCode(symbol.value)]++;
+                distanceFrequencies[distanceCode(symbol.distance)]++;
+            }
+        }
+        literalFrequencies[END_OF_BLOCK]++;
+
+        // Decoders reject incomplete codes, make sure both trees have at least two leaves
+        const auto used = [](uint32_t p_frequency) { return p_frequency > 0; };
+        if (std::count_if(literalFrequencies, literalFrequencies + LITERAL_CODES, used) < 2) {
+            literalFrequencies[0]++;
+        }
+        for (int code = 0; code < 2; code++) {
+            if (distanceFrequencies[code] == 0) { distanceFrequencies[code] = 1; }
+        }
+
+        uint8_t lengths[LITERAL_CODES + DISTANCE_CODES];
+        uint8_t* const distanceLengths = lengths + LITERAL_CODES;
+        buildLengths(literalFrequencies, LITERAL_CODES, 15, lengths);
+        buildLengths(distanceFrequencies, DISTANCE_CODES, 15, distanceLengths);
+
+        int literalCount = LITERAL_CODES;
+        while (literalCount > 257 && lengths[literalCount - 1] == 0) { literalCount--; }
+        int distanceCount = DISTANCE_CODES;
+        while (distanceCount > 1 && distanceLengths[distanceCount - 1] == 0) { distanceCount--; }
+
+        // Both length sequences are encoded as one
+        uint8_t combined[LITERAL_CODES + DISTANCE_CODES];
+        std::copy(lengths, lengths + literalCount, combined);
+        std::copy(distanceLengths, distanceLengths + distanceCount, combined + literalCount);
+        const std::vector<uint32_t> lengthSymbols = encodeLengths(combined, literalCount + distanceCount);
+
+        uint32_t lengthFrequencies[LENGTH_CODES] = {};
+        for (uint32_t symbol : lengthSymbols) { lengthFrequencies[symbol & 0xFF]++; }
+        uint8_t lengthLengths[LENGTH_CODES];
+        buildLengths(lengthFrequencies, LENGTH_CODES, 7, lengthLengths);
+        uint16_t lengthCodes[LENGTH_CODES] = {};
+        buildCodes(lengthLengths, LENGTH_CODES, lengthCodes);
+
+        int lengthCount = LENGTH_CODES;
+        while (lengthCount > 4 && lengthLengths[LENGTH_ORDER[lengthCount - 1]] == 0) { lengthCount--; }
+
+        uint16_t literalCodes[LITERAL_CODES] = {};
+        uint16_t distanceCodes[DISTANCE_CODES] = {};
+        buildCodes(lengths, LITERAL_CODES, literalCodes);
+        buildCodes(distanceLengths, DISTANCE_CODES, distanceCodes);
+
+        // Header: not final, dynamic Huffman codes
+        p_writer.write(0, 1);
+        p_writer.write(2, 2);
+        p_writer.write(literalCount - 257, 5);
+        p_writer.write(distanceCount - 1, 5);
+        p_writer.write(lengthCount - 4, 4);
+        for (int i = 0; i < lengthCount; i++) { p_writer.write(lengthLengths[LENGTH_ORDER[i]], 3); }
+        for (uint32_t symbol : lengthSymbols) {
+            const int code = symbol & 0xFF;
+            p_writer.write(lengthCodes[code], lengthLengths[code]);
+            if (code == 16) p_writer.write(symbol >> 8, 2);
+            if (code == 17) p_writer.write(symbol >> 8, 3);
+            if (code == 18) p_writer.write(symbol >> 8, 7);
+        }
+
+        for (const Symbol& symbol : p_symbols) {
+            if (symbol.distance == 0) {
+                p_writer.write(literalCodes[symbol.value], lengths[symbol.value]);
+                continue;
+            }
+            const int length = lengthCode(symbol.value);
+            p_writer.write(literalCodes[257 + length], lengths[257 + length]);
+            p_writer.write(symbol.value - LENGTH_BASE[length], LENGTH_EXTRA[length]);
+            const int distance = distanceCode(symbol.distance);
+            p_writer.write(distanceCodes[distance], distanceLengths[distance]);
+            p_writer.write(symbol.distance - DISTANCE_BASE[distance], DISTANCE_EXTRA[distance]);
+        }
+        p_writer.write(literalCodes[END_OF_BLOCK], lengths[END_OF_BLOCK]);
+    }
+
+    std::array<uint32_t, 256> makeCrcTable() {
+        std::array<uint32_t, 256> table;
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) { crc = crc & 1 ? 0xEDB88320u ^ (crc >> 1) : crc >> 1; }
+            table[i] = crc;
+        }
+        return table;
+    }
+}
+
+void Deflate::compress(const uint8_t* p_data, size_t p_size, size_t p_dictionary, std::vector<uint8_t>& p_out) {
+    BitWriter writer(p_out);
+
+    // Positions are relative to the start of the used dictionary
+    const size_t dictionary = std::min(p_dictionary, WINDOW_SIZE);
+    const uint8_t* const base = p_data - dictionary;
+    const size_t end = dictionary + p_size;
+
+    std::vector<int32_t> head(size_t(1) << HASH_BITS, -1);
+    for (size_t position = 0; position < dictionary && position + MIN_MATCH <= end; position++) {
+        head[hash(base + position)] = static_cast<int32_t>(position);
+    }
+
+    std::vector<Symbol> symbols;
+    symbols.reserve(BLOCK_SYMBOLS);
+    for (size_t position = dictionary; position < end;) {
+        size_t length = 0;
+        size_t distance = 0;
+        if (position + MIN_MATCH <= end) {
+            int32_t& entry = head[hash(base + position)];
+            const int32_t candidate = entry;
+            entry = static_cast<int32_t>(position);
+
+            if (candidate >= 0 && position - candidate <= WINDOW_SIZE) {
+                const size_t maxLength = std::min(MAX_MATCH, end - position);
+                while (length < maxLength && base[candidate + length] == base[position + length]) { length++; }
+                distance = position - candidate;
+            }
+        }
+
+        if (length >= MIN_MATCH) {
+            symbols.push_back({static_cast<uint16_t>(length), static_cast<uint16_t>(distance)});
+            for (size_t i = 1; i < length && position + i + MIN_MATCH <= end; i++) {
+                head[hash(base + position + i)] = static_cast<int32_t>(position + i);
+            }
+            position += length;
+        } else {
+            symbols.push_back({base[position], 0});
+            position++;
+        }
+
+        if (symbols.size() == BLOCK_SYMBOLS) {
+            writeBlock(writer, symbols);
+            symbols.clear();
+        }
+    }
+    if (!symbols.empty()) { writeBlock(writer, symbols); }
+
+    // Empty stored block: the piece ends byte aligned (like Z_SYNC_FLUSH)
+    writer.write(0, 3);
+    writer.alignToByte();
+    p_out.insert(p_out.end(), {0x00, 0x00, 0xFF, 0xFF});
+}
+
+void Deflate::finish(std::vector<uint8_t>& p_out) {
+    // Empty final stored block
+    p_out.insert(p_out.end(), {0x01, 0x00, 0x00, 0xFF, 0xFF});
+}
+
+uint32_t Deflate::adler32(uint32_t p_adler, const uint8_t* p_data, size_t p_size) {
+    constexpr uint32_t modulus = 65521;
+    // Largest number of bytes before the sums could overflow
+    constexpr size_t maxRun = 5552;
+
+    uint32_t a = p_adler & 0xFFFF;
+    uint32_t b = p_adler >> 16;
+    while (p_size > 0) {
+        const size_t run = std::min(p_size, maxRun);
+        for (size_t i = 0; i < run; i++) {
+            a += p_data[i];
+            b += a;
+        }
+        a %= modulus;
+        b %= modulus;
+        p_data += run;
+        p_size -= run;
+    }
+    return (b << 16) | a;
+}
+
+uint32_t Deflate::combineAdler32(uint32_t p_first, uint32_t p_second, size_t p_secondSize) {
+    constexpr uint32_t modulus = 65521;
+    const uint32_t remainder = static_cast<uint32_t>(p_secondSize % modulus);
+
+    uint32_t a = p_first & 0xFFFF;
+    uint32_t b = static_cast<uint32_t>((static_cast<uint64_t>(remainder) * a) % modulus);
+    a += (p_second & 0xFFFF) + modulus - 1;
+    b += (p_first >> 16) + (p_second >> 16) + modulus - remainder;
+    if (a >= modulus) a -= modulus;
+    if (a >= modulus) a -= modulus;
+    if (b >= 2 * modulus) b -= 2 * modulus;
+    if (b >= modulus) b -= modulus;
+    return (b << 16) | a;
+}
+
+uint32_t Deflate::crc32(uint32_t p_crc, const uint8_t* p_data, size_t p_size) {
+    static const std::array<uint32_t, 256> table = makeCrcTable();
+
+    uint32_t crc = ~p_crc;
+    for (size_t i = 0; i < p_size; i++) { crc = table[(crc ^ p_data[i]) & 0xFF] ^ (crc >> 8); }
+    return ~crc;
+}
@@ -0,0 +1,25 @@
+#include <image/IImageWriter.hpp>
+#include <image/PngWriter.hpp>
+#include <image/PpmWriter.hpp>
+
+#include <algorithm>
+#include <cctype>
+
+bool isPngPath(const std::string& p_path) {
+    std::string extension = p_path.size() >= 4 ? p_path.substr(p_path.size() - 4) : "";
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char p_character) { return static_cast<char>(std::tolower(p_character)); });
+    return extension == ".png";
+}
+
+std::unique_ptr<IImageWriter> createImageWriter(const std::string& p_path, int p_width, int p_height,
+                                                TileScheduler& p_scheduler) {
+    if (isPngPath(p_path)) return std::make_unique<PngWriter>(p_path, p_width, p_height, p_scheduler);
+    return std::make_unique<PpmWriter>(p_path, p_width, p_height);
+}
+
+void saveImage(const std::string& p_path, const Image& p_image, TileScheduler& p_scheduler) {
+    std::unique_ptr<IImageWriter> writer = createImageWriter(p_path, p_image.width, p_image.height, p_scheduler);
+    writer->writeRows(p_image.pixels.data(), p_image.height);
+    writer->finish();
+}
@@ -0,0 +1,183 @@
+#include <cpu/TileScheduler.hpp>
+#include <exception/ImageWriteError.hpp>
+#include <image/Deflate.hpp>
+#include <image/PngWriter.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+    constexpr uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    // Uncompressed size of the pieces, which are compressed in parallel
+    constexpr size_t PIECE_SIZE = 128 * 1024;
+    constexpr size_t WINDOW_SIZE = 32768;
+    constexpr int BYTES_PER_PIXEL = 3;
+
+    void putBigEndian(std::vector<uint8_t>& p_out, uint32_t p_value) {
+        for (int shift = 24; shift >= 0; shift -= 8) { p_out.push_back(static_cast<uint8_t>(p_value >> shift)); }
+    }
+
+    inline uint8_t paeth(int p_left, int p_up, int p_upLeft) {
+        const int estimate = p_left + p_up - p_upLeft;
+        const int left = std::abs(estimate - p_left);
+        const int up = std::abs(estimate - p_up);
+        const int upLeft = std::abs(estimate - p_upLeft);
+        if (left <= up && left <= upLeft) return static_cast<uint8_t>(p_left);
+        return static_cast<uint8_t>(up <= upLeft ? p_up : p_upLeft);
+    }
+
+    /**
+     * Apply the filter of the smallest sum of absolute differences (the heuristic recommended by the PNG
+     * specification). p_out receives the filter type followed by the filtered row, p_scratch holds p_size bytes.
+     */
+    void filterRow(const uint8_t* p_row, const uint8_t* p_previous, size_t p_size, uint8_t* p_out,
+                   uint8_t* p_scratch) {
+        uint64_t bestCost = UINT64_MAX;
+        for (uint8_t type = 0; type < 5; type++) {
+            uint8_t* const filtered = type == 0 ? p_out + 1 : p_scratch;
+            uint64_t cost = 0;
+            for (size_t i = 0; i < p_size; i++) {
+                const int left = i >= BYTES_PER_PIXEL ? p_row[i - BYTES_PER_PIXEL] : 0;
+                const int up = p_previous[i];
+                const int upLeft = i >= BYTES_PER_PIXEL ? p_previous[i - BYTES_PER_PIXEL] : 0;
+                uint8_t predicted = 0;
+                switch (type) {
+                    case 1: predicted = static_cast<uint8_t>(left); break;
+                    case 2: predicted = static_cast<uint8_t>(up); break;
+                    case 3: predicted = static_cast<uint8_t>((left + up) >> 1); break;
+                    case 4: predicted = paeth(left, up, upLeft); break;
+                }
+                filtered[i] = static_cast<uint8_t>(p_row[i] - predicted);
+                cost += std::abs(static_cast<int8_t>(filtered[i]));
+            }
+            if (cost < bestCost) {
+                bestCost = cost;
+                p_out[0] = type;
+                if (type > 0) { std::memcpy(p_out + 1, p_scratch, p_size); }
+            }
+        }
+    }
+}
+
+PngWriter::PngWriter(const std::string& p_path, int p_width, int p_height, TileScheduler& p_scheduler)
+    : _path(p_path),
+      _width(p_width),
+      _height(p_height),
+      _scheduler(p_scheduler),
+      _file(p_path, std::ios::binary | std::ios::trunc),
+      _stream(_file),
+      _previousRow(static_cast<size_t>(p_width) * BYTES_PER_PIXEL, 0) {
+    if (!_file) throw ImageWriteError(_path, "can't be created");
+    writeHeader();
+}
+
+PngWriter::PngWriter(std::ostream& p_stream, int p_width, int p_height, TileScheduler& p_scheduler)
+    : _path("stream"),
+      _width(p_width),
+      _height(p_height),
+      _scheduler(p_scheduler),
+      _stream(p_stream),
+      _previousRow(static_cast<size_t>(p_width) * BYTES_PER_PIXEL, 0) {
+    writeHeader();
+}
+
+void PngWriter::writeHeader() {
+    _stream.write(reinterpret_cast<const char*>(SIGNATURE), sizeof(SIGNATURE));
+
+    // 8 bits per channel, RGB, deflate, adaptive filtering, no interlacing
+    std::vector<uint8_t> header;
+    putBigEndian(header, static_cast<uint32_t>(_width));
+    putBigEndian(header, static_cast<uint32_t>(_height));
+    header.insert(header.end(), {8, 2, 0, 0, 0});
+    writeChunk("IHDR", header);
+
+    // zlib header: deflate with a 32 KiB window, the pieces follow in IDAT chunks of their own
+    writeChunk("IDAT", {0x78, 0x01});
+}
+
+void PngWriter::writeRows(const uint8_t* p_pixels, int p_rows) {
+    if (p_rows > _height - _writtenRows) throw ImageWriteError(_path, "more rows than the image height");
+    if (p_rows <= 0) return;
+
+    const size_t rowSize = static_cast<size_t>(_width) * BYTES_PER_PIXEL;
+    const size_t filteredRowSize = rowSize + 1;
+    const int rowsPerPiece = static_cast<int>(std::max<size_t>(1, PIECE_SIZE / filteredRowSize));
+
+    std::vector<Tile> pieces;
+    for (int row = 0; row < p_rows; row += rowsPerPiece) {
+        pieces.push_back({0, row, _width, std::min(rowsPerPiece, p_rows - row)});
+    }
+
+    // The history of the previous band comes first, pieces may refer back into it
+    std::vector<uint8_t> filtered(_history.size() + p_rows * filteredRowSize);
+    std::copy(_history.begin(), _history.end(), filtered.begin());
+    uint8_t* const rows = filtered.data() + _history.size();
+
+    _scheduler.run(pieces, [&](const Tile& p_piece, unsigned) {
+        std::vector<uint8_t> scratch(rowSize);
+        for (int row = p_piece.y; row < p_piece.y + p_piece.height; row++) {
+            const uint8_t* previous = row > 0 ? p_pixels + (row - 1) * rowSize : _previousRow.data();
+            filterRow(p_pixels + row * rowSize, previous, rowSize, rows + row * filteredRowSize, scratch.data());
+        }
+    });
+
+    // Compression needs the filtered rows in front of a piece, so it's a second pass
+    std::vector<std::vector<uint8_t>> compressed(pieces.size());
+    std::vector<uint32_t> adlers(pieces.size());
+    std::vector<uint32_t> crcs(pieces.size());
+    _scheduler.run(pieces, [&](const Tile& p_piece, unsigned) {
+        const size_t index = p_piece.y / rowsPerPiece;
+        const size_t offset = p_piece.y * filteredRowSize;
+        const size_t size = p_piece.height * filteredRowSize;
+
+        std::vector<uint8_t>& piece = compressed[index];
+        piece.reserve(size / 4);
+        Deflate::compress(rows + offset, size, _history.size() + offset, piece);
+        adlers[index] = Deflate::adler32(1, rows + offset, size);
+        crcs[index] = Deflate::crc32(Deflate::crc32(0, reinterpret_cast<const uint8_t*>("IDAT"), 4), piece.data(),
+                                     piece.size());
+    });
+
+    for (size_t index = 0; index < pieces.size(); index++) {
+        writeChunk("IDAT", compressed[index].data(), compressed[index].size(), crcs[index]);
+        _adler = Deflate::combineAdler32(_adler, adlers[index], pieces[index].height * filteredRowSize);
+    }
+    if (!_stream) throw ImageWriteError(_path, "write failed");
+
+    const size_t historySize = std::min(WINDOW_SIZE, filtered.size());
+    _history.assign(filtered.end() - historySize, filtered.end());
+    std::copy(p_pixels + (p_rows - 1) * rowSize, p_pixels + p_rows * rowSize, _previousRow.begin());
+    _writtenRows += p_rows;
+}
+
+void PngWriter::finish() {
+    if (_writtenRows != _height) throw ImageWriteError(_path, "rows missing");
+
+    std::vector<uint8_t> end;
+    Deflate::finish(end);
+    putBigEndian(end, _adler);
+    writeChunk("IDAT", end);
+    writeChunk("IEND", {});
+
+    if (_file.is_open()) { _file.close(); }
+    if (!_stream) throw ImageWriteError(_path, "write failed");
+}
+
+void PngWriter::writeChunk(const char* p_type, const uint8_t* p_data, size_t p_size, uint32_t p_crc) {
+    std::vector<uint8_t> header;
+    putBigEndian(header, static_cast<uint32_t>(p_size));
+    header.insert(header.end(), p_type, p_type + 4);
+    std::vector<uint8_t> crc;
+    putBigEndian(crc, p_crc);
+
+    _stream.write(reinterpret_cast<const char*>(header.data()), header.size());
+    _stream.write(reinterpret_cast<const char*>(p_data), p_size);
+    _stream.write(reinterpret_cast<const char*>(crc.data()), crc.size());
+}
+
+void PngWriter::writeChunk(const char* p_type, const std::vector<uint8_t>& p_data) {
+    const uint32_t crc = Deflate::crc32(Deflate::crc32(0, reinterpret_cast<const uint8_t*>(p_type), 4),
+                                        p_data.data(), p_data.size());
+    writeChunk(p_type, p_data.data(), p_data.size(), crc);
+}
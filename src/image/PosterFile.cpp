@@ -0,0 +1,67 @@
+#include <exception/ImageWriteError.hpp>
+#include <image/PosterFile.hpp>
+
+#include <filesystem>
+
+PosterFile::PosterFile(const std::string& p_path, int p_width, int p_height, const std::string& p_job)
+    : _path(p_path), _progressPath(p_path + ".progress"), _job(p_job), _width(p_width), _height(p_height) {
+    namespace fs = std::filesystem;
+    const std::string header = "P6\n" + std::to_string(p_width) + " " + std::to_string(p_height) + "\n255\n";
+    _headerSize = static_cast<std::streamoff>(header.size());
+    const uintmax_t size = header.size() + static_cast<uintmax_t>(p_width) * p_height * 3;
+
+    // Resume, if the progress belongs to this job and the file is intact
+    std::error_code error;
+    std::ifstream progress(_progressPath);
+    std::string job;
+    int rows = 0;
+    if (progress && std::getline(progress, job) && progress >> rows && job == _job && rows >= 0 && rows <= p_height &&
+        fs::file_size(_path, error) == size) {
+        _completedRows = rows;
+    }
+    progress.close();
+
+    if (_completedRows == 0) {
+        std::ofstream file(_path, std::ios::binary | std::ios::trunc);
+        file << header;
+        file.close();
+        if (!file) throw ImageWriteError(_path, "can't be created");
+
+        fs::resize_file(_path, size, error);
+        if (error) throw ImageWriteError(_path, error.message());
+        saveProgress();
+    }
+
+    _file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!_file) throw ImageWriteError(_path, "can't be opened");
+}
+
+void PosterFile::writeRows(const uint8_t* p_pixels, int p_rows) {
+    const std::streamoff rowSize = static_cast<std::streamoff>(_width) * 3;
+    _file.seekp(_headerSize + _completedRows * rowSize);
+    _file.write(reinterpret_cast<const char*>(p_pixels), p_rows * rowSize);
+    // The rows must be in the file before the progress says so
+    _file.flush();
+    if (!_file) throw ImageWriteError(_path, "write failed");
+
+    _completedRows += p_rows;
+    saveProgress();
+}
+
+void PosterFile::finish() {
+    _file.close();
+    std::error_code error;
+    std::filesystem::remove(_progressPath, error);
+}
+
+void PosterFile::saveProgress() const {
+    const std::string temporaryPath = _progressPath + ".tmp";
+    std::ofstream progress(temporaryPath, std::ios::trunc);
+    progress << _job << "\n" << _completedRows << "\n";
+    progress.close();
+    if (!progress) throw ImageWriteError(_progressPath, "write failed");
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, _progressPath, error);
+    if (error) throw ImageWriteError(_progressPath, error.message());
+}
@@ -0,0 +1,32 @@
+#include <exception/ImageWriteError.hpp>
+#include <image/PpmWriter.hpp>
+
+PpmWriter::PpmWriter(const std::string& p_path, int p_width, int p_height)
+    : _path(p_path),
+      _width(p_width),
+      _height(p_height),
+      _file(p_path, std::ios::binary | std::ios::trunc),
+      _stream(_file) {
+    _file << "P6\n" << p_width << " " << p_height << "\n255\n";
+    if (!_file) throw ImageWriteError(_path, "can't be created");
+}
+
+PpmWriter::PpmWriter(std::ostream& p_stream, int p_width, int p_height)
+    : _path("stream"), _width(p_width), _height(p_height), _stream(p_stream) {
+    _stream << "P6\n" << p_width << " " << p_height << "\n255\n";
+}
+
+void PpmWriter::writeRows(const uint8_t* p_pixels, int p_rows) {
+    if (p_rows > _height - _writtenRows) throw ImageWriteError(_path, "more rows than the image height");
+
+    _stream.write(reinterpret_cast<const char*>(p_pixels), static_cast<std::streamsize>(p_rows) * _width * 3);
+    if (!_stream) throw ImageWriteError(_path, "write failed");
+    _writtenRows += p_rows;
+}
+
+void PpmWriter::finish() {
+    if (_writtenRows != _height) throw ImageWriteError(_path, "rows missing");
+
+    if (_file.is_open()) { _file.close(); }
+    if (!_stream) throw ImageWriteError(_path, "write failed");
+}
@@ -0,0 +1,76 @@
+#include <perturbation/BilinearApproximation.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Relative error tolerated per step (double precision)
+    constexpr double epsilon = 1.0 / 9007199254740992.0;
+
+    BlaStep merge(const BlaStep& p_first, const BlaStep& p_second, double p_maxDeltaC) {
+        BlaStep result;
+        // A = A_y * A_x, B = A_y * B_x + B_y
+        result.aReal = p_second.aReal * p_first.aReal - p_second.aImaginary * p_first.aImaginary;
+        result.aImaginary = p_second.aReal * p_first.aImaginary + p_second.aImaginary * p_first.aReal;
+        result.bReal = p_second.aReal * p_first.bReal - p_second.aImaginary * p_first.bImaginary + p_second.bReal;
+        result.bImaginary =
+            p_second.aReal * p_first.bImaginary + p_second.aImaginary * p_first.bReal + p_second.bImaginary;
+
+        // The second step must still be valid for the d produced by the first one
+        const double firstA = std::hypot(p_first.aReal, p_first.aImaginary);
+        const double firstB = std::hypot(p_first.bReal, p_first.bImaginary);
+        const double secondRadius = firstA > 0.0 ? (p_second.radius - firstB * p_maxDeltaC) / firstA : 0.0;
+        result.radius = std::min(p_first.radius, std::max(0.0, secondRadius));
+        result.length = p_first.length + p_second.length;
+        return result;
+    }
+}
+
+void BilinearApproximation::compute(const ReferenceOrbit& p_orbit, double p_maxDeltaC) {
+    _maxDeltaC = p_maxDeltaC;
+    _levels.clear();
+
+    // Steps for m = 1 ... length - 2, so every skip lands on a stored Z
+    const int stepCount = p_orbit.getLength() - 2;
+    if (stepCount <= 0) return;
+
+    std::vector<BlaStep> level;
+    level.reserve(stepCount);
+    for (int m = 1; m <= stepCount; m++) {
+        const double zReal = p_orbit.getReal(m);
+        const double zImaginary = p_orbit.getImaginary(m);
+        const double zNorm = std::hypot(zReal, zImaginary);
+
+        // d^2 is dropped, which is negligible while |d| << |Z|
+        const double radius = epsilon * std::max(0.0, zNorm - p_maxDeltaC) / (2.0 * zNorm + 1.0);
+        level.push_back({2.0 * zReal, 2.0 * zImaginary, 1.0, 0.0, radius, 1});
+    }
+    _levels.push_back(std::move(level));
+
+    while (_levels.back().size() > 1) {
+        const std::vector<BlaStep>& previous = _levels.back();
+        std::vector<BlaStep> next;
+        next.reserve((previous.size() + 1) / 2);
+        for (size_t i = 0; i < previous.size(); i += 2) {
+            next.push_back(i + 1 < previous.size() ? merge(previous[i], previous[i + 1], p_maxDeltaC) : previous[i]);
+        }
+        _levels.push_back(std::move(next));
+    }
+}
+
+std::vector<double> BilinearApproximation::serialize(std::vector<int>& p_levelOffsets) const {
+    std::vector<double> values;
+    p_levelOffsets.clear();
+
+    int offset = 0;
+    for (const std::vector<BlaStep>& level : _levels) {
+        p_levelOffsets.push_back(offset);
+        offset += static_cast<int>(level.size());
+        for (const BlaStep& step : level) {
+            values.insert(values.end(),
+                          {step.aReal, step.aImaginary, step.bReal, step.bImaginary, step.radius,
+                           static_cast<double>(step.length)});
+        }
+    }
+    return values;
+}
@@ -0,0 +1,149 @@
+#include <perturbation/ExponentialMap.hpp>
+#include <perturbation/PerturbationKernel.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr double TWO_PI = 6.283185307179586;
+    // Rings per task
+    constexpr int RING_BATCH = 4;
+    // The BLA table is rebuilt once the rings shrank by this factor, its steps get longer for smaller |dc|
+    constexpr double APPROXIMATION_RANGE = 65536.0;
+}
+
+ExponentialMap::ExponentialMap(const FixedPoint& p_real,
+                               const FixedPoint& p_imaginary,
+                               const FloatExp& p_anchor,
+                               int p_angles,
+                               int p_maxIterations)
+    : _angles(p_angles), _step(TWO_PI / p_angles), _anchor(p_anchor), _maxIterations(p_maxIterations) {
+    _orbit.compute(p_real, p_imaginary, p_maxIterations);
+}
+
+int ExponentialMap::getAnglesFor(int p_width, int p_height) {
+    return static_cast<int>(std::ceil(TWO_PI * std::hypot(p_width / 2.0, p_height / 2.0)));
+}
+
+void ExponentialMap::renderFrame(const FloatExp& p_pixelSize,
+                                 int p_maxIterations,
+                                 IterationBuffer& p_buffer,
+                                 const std::vector<Tile>& p_regions,
+                                 TileScheduler& p_scheduler) {
+    const int width = p_buffer.getWidth();
+    const int height = p_buffer.getHeight();
+
+    // From the outer corner to the pixel centers closest to the zoom center
+    const double pixelSizeLog = p_pixelSize.log();
+    const double outer = getRingPosition(p_pixelSize * FloatExp(std::hypot(width / 2.0, height / 2.0)));
+    // Pixels closer than half a pixel (only the center pixel of odd sizes) use the innermost ring
+    const double inner = getRingPosition(p_pixelSize * FloatExp(0.5));
+    prepareRings(static_cast<int>(std::floor(outer)), static_cast<int>(std::ceil(inner)), p_scheduler);
+
+    const double anchorLog = _anchor.log();
+    const int lastRing = _firstRing + static_cast<int>(_rings.size()) - 1;
+    std::vector<Tile> tiles;
+    for (const Tile& region : p_regions) {
+        for (Tile tile : TileScheduler::splitIntoTiles(region.width, region.height, 64)) {
+            tile.x += region.x;
+            tile.y += region.y;
+            tiles.push_back(tile);
+        }
+    }
+    p_scheduler.run(tiles, [&](const Tile& p_tile, unsigned) {
+        for (int y = p_tile.y; y < p_tile.y + p_tile.height; y++) {
+            const double offsetY = y + 0.5 - height / 2.0;
+            for (int x = p_tile.x; x < p_tile.x + p_tile.width; x++) {
+                const double offsetX = x + 0.5 - width / 2.0;
+                const double distance2 = std::max(offsetX * offsetX + offsetY * offsetY, 0.25);
+                const double radiusLog = pixelSizeLog + 0.5 * std::log(distance2);
+                const int ring = std::clamp(static_cast<int>(std::lround((anchorLog - radiusLog) / _step)),
+                                            _firstRing, lastRing);
+                const double angle = std::atan2(offsetY, offsetX);
+                const double turn = angle < 0.0 ? angle + TWO_PI : angle;
+                const int index = static_cast<int>(std::lround(turn / _step)) % _angles;
+                p_buffer.at(x, y) = std::min(_rings[ring - _firstRing][index], static_cast<uint32_t>(p_maxIterations));
+            }
+        }
+    });
+}
+
+void ExponentialMap::prepareRings(int p_first, int p_last, TileScheduler& p_scheduler) {
+    const int currentLast = _firstRing + static_cast<int>(_rings.size()) - 1;
+    if (_rings.empty() || p_last < _firstRing || p_first > currentLast) {
+        // Nothing to keep (first frame, or a jump)
+        _rings.clear();
+        _firstRing = p_first;
+    }
+
+    while (_firstRing < p_first && !_rings.empty()) {
+        _rings.pop_front();
+        _firstRing++;
+    }
+    if (_rings.empty()) _firstRing = p_first;
+
+    // Zooming out: rings in front, zooming in: rings behind the computed ones
+    if (p_first < _firstRing) {
+        std::vector<std::vector<uint32_t>> rings;
+        computeRings(p_first, _firstRing - 1, rings, p_scheduler);
+        _rings.insert(_rings.begin(), rings.begin(), rings.end());
+        _firstRing = p_first;
+    }
+    const int last = _firstRing + static_cast<int>(_rings.size()) - 1;
+    if (p_last > last) {
+        std::vector<std::vector<uint32_t>> rings;
+        computeRings(last + 1, p_last, rings, p_scheduler);
+        _rings.insert(_rings.end(), rings.begin(), rings.end());
+    }
+}
+
+void ExponentialMap::computeRings(int p_first,
+                                  int p_last,
+                                  std::vector<std::vector<uint32_t>>& p_rings,
+                                  TileScheduler& p_scheduler) {
+    // The largest |dc| of these rings bounds the BLA radii
+    const double maxDeltaC = getRingRadius(p_first).toDouble();
+    if (!_approximationValid || maxDeltaC > _approximation.getMaxDeltaC() ||
+        maxDeltaC * APPROXIMATION_RANGE < _approximation.getMaxDeltaC()) {
+        _approximation.compute(_orbit, maxDeltaC);
+        _approximationValid = true;
+    }
+
+    const int count = p_last - p_first + 1;
+    p_rings.assign(count, std::vector<uint32_t>(_angles));
+    std::vector<Tile> batches;
+    for (int ring = 0; ring < count; ring += RING_BATCH) {
+        batches.push_back({ring, 0, std::min(RING_BATCH, count - ring), _angles});
+    }
+
+    p_scheduler.run(batches, [&](const Tile& p_batch, unsigned) {
+        PerturbationStatistics statistics;
+        for (int ring = p_batch.x; ring < p_batch.x + p_batch.width; ring++) {
+            const FloatExp radius = getRingRadius(p_first + ring);
+            std::vector<uint32_t>& samples = p_rings[ring];
+            for (int angle = 0; angle < _angles; angle++) {
+                const FloatExp deltaReal = radius * FloatExp(std::cos(angle * _step));
+                const FloatExp deltaImaginary = radius * FloatExp(std::sin(angle * _step));
+                if (std::max(deltaReal.exponent, deltaImaginary.exponent) >= PerturbationKernel::minDoubleExponent) {
+                    samples[angle] = PerturbationKernel::iterate(_orbit, &_approximation, deltaReal.toDouble(),
+                                                                 deltaImaginary.toDouble(), _maxIterations, statistics);
+                } else {
+                    samples[angle] = PerturbationKernel::iterateExtended(_orbit, &_approximation, deltaReal,
+                                                                         deltaImaginary, _maxIterations, statistics);
+                }
+            }
+        }
+    });
+    _computedSamples += static_cast<uint64_t>(count) * _angles;
+}
+
+FloatExp ExponentialMap::getRingRadius(int p_ring) const {
+    // Via the binary logarithm, e^(-i * step) alone would underflow for zooms beyond ~1e-308
+    const double radiusLog2 = (_anchor.log() - p_ring * _step) / std::log(2.0);
+    const double exponent = std::floor(radiusLog2);
+    return FloatExp::normalized(std::exp2(radiusLog2 - exponent), static_cast<int64_t>(exponent));
+}
+
+double ExponentialMap::getRingPosition(const FloatExp& p_radius) const {
+    return (_anchor.log() - p_radius.log()) / _step;
+}
@@ -0,0 +1,134 @@
+#include <perturbation/PerturbationKernel.hpp>
+
+#include <algorithm>
+
+void PerturbationKernel::renderTile(const Viewport& p_viewport, const Tile& p_tile, IterationBuffer& p_buffer) {
+    const int width = p_buffer.getWidth();
+    const int height = p_buffer.getHeight();
+    const FloatExp pixelSize = p_viewport.getExtendedPixelSize(width);
+    PerturbationStatistics statistics;
+
+    for (int y = p_tile.y; y < p_tile.y + p_tile.height; y++) {
+        const FloatExp deltaImaginary = _offset.second + FloatExp(y + 0.5 - height / 2.0) * pixelSize;
+        for (int x = p_tile.x; x < p_tile.x + p_tile.width; x++) {
+            const FloatExp deltaReal = _offset.first + FloatExp(x + 0.5 - width / 2.0) * pixelSize;
+            if (std::max(deltaReal.exponent, deltaImaginary.exponent) >= minDoubleExponent) {
+                p_buffer.at(x, y) = iterate(*_orbit, _approximation, deltaReal.toDouble(), deltaImaginary.toDouble(),
+                                            p_viewport.maxIterations, statistics);
+            } else {
+                p_buffer.at(x, y) = iterateExtended(
+                    *_orbit, _approximation, deltaReal, deltaImaginary, p_viewport.maxIterations, statistics);
+            }
+        }
+    }
+    _skippedIterations += statistics.skippedIterations;
+    _rebases += statistics.rebases;
+}
+
+uint32_t PerturbationKernel::iterate(const ReferenceOrbit& p_orbit,
+                                     const BilinearApproximation* p_approximation,
+                                     double p_deltaReal,
+                                     double p_deltaImaginary,
+                                     int p_maxIterations,
+                                     PerturbationStatistics& p_statistics) {
+    return iterate(p_orbit, p_approximation, p_deltaReal, p_deltaImaginary, 0.0, 0.0, 0, 0, p_maxIterations,
+                   p_statistics);
+}
+
+uint32_t PerturbationKernel::iterateExtended(const ReferenceOrbit& p_orbit,
+                                             const BilinearApproximation* p_approximation,
+                                             const FloatExp& p_deltaReal,
+                                             const FloatExp& p_deltaImaginary,
+                                             int p_maxIterations,
+                                             PerturbationStatistics& p_statistics) {
+    FloatExp dReal;
+    FloatExp dImaginary;
+
+    // While d is this tiny, z = Z + d equals Z in double precision: it can't escape before the reference does and it
+    // can't get closer to 0 than d, neither escape checks nor rebasing are needed until the end of the reference
+    const int lastReference = p_orbit.getLength() - 1;
+    int i = 0;
+    int m = 0;
+    while (i < p_maxIterations && m < lastReference &&
+           std::max(dReal.exponent, dImaginary.exponent) < minDoubleExponent) {
+        const FloatExp referenceReal = p_orbit.getReal(m);
+        const FloatExp referenceImaginary = p_orbit.getImaginary(m);
+
+        // d' = 2 * Z * d + d^2 + dc
+        const FloatExp nextReal = (referenceReal * dReal - referenceImaginary * dImaginary).twice() +
+                                  (dReal * dReal - dImaginary * dImaginary) + p_deltaReal;
+        dImaginary = (referenceReal * dImaginary + referenceImaginary * dReal + dReal * dImaginary).twice() +
+                     p_deltaImaginary;
+        dReal = nextReal;
+        i++;
+        m++;
+    }
+
+    // dc may underflow now, it is negligible against d
+    return iterate(p_orbit, p_approximation, p_deltaReal.toDouble(), p_deltaImaginary.toDouble(), dReal.toDouble(),
+                   dImaginary.toDouble(), i, m, p_maxIterations, p_statistics);
+}
+
+uint32_t PerturbationKernel::iterate(const ReferenceOrbit& p_orbit,
+                                     const BilinearApproximation* p_approximation,
+                                     double p_deltaReal,
+                                     double p_deltaImaginary,
+                                     double p_dReal,
+                                     double p_dImaginary,
+                                     int p_iteration,
+                                     int p_position,
+                                     int p_maxIterations,
+                                     PerturbationStatistics& p_statistics) {
+    double dReal = p_dReal;
+    double dImaginary = p_dImaginary;
+
+    // i counts the iterations of the pixel, m is the current position on the reference orbit
+    const int lastReference = p_orbit.getLength() - 1;
+    int i = p_iteration;
+    int m = p_position;
+    while (i < p_maxIterations) {
+        double referenceReal = p_orbit.getReal(m);
+        double referenceImaginary = p_orbit.getImaginary(m);
+        const double zReal = referenceReal + dReal;
+        const double zImaginary = referenceImaginary + dImaginary;
+        const double zNorm2 = zReal * zReal + zImaginary * zImaginary;
+        if (zNorm2 > 4.0) break;
+
+        // Rebase: once z is closer to 0 than d (precision loss, the source of glitches) or the reference ran out,
+        // continue with d = z relative to the start of the reference orbit (Z_0 = 0)
+        if (zNorm2 < dReal * dReal + dImaginary * dImaginary || m == lastReference) {
+            dReal = zReal;
+            dImaginary = zImaginary;
+            referenceReal = 0.0;
+            referenceImaginary = 0.0;
+            m = 0;
+            p_statistics.rebases++;
+        }
+
+        // Skip as many iterations as the BLA table allows
+        const BlaStep* step = p_approximation ? p_approximation->lookup(m, dReal * dReal + dImaginary * dImaginary,
+                                                                        p_maxIterations - i)
+                                              : nullptr;
+        if (step) {
+            const double nextReal = step->aReal * dReal - step->aImaginary * dImaginary + step->bReal * p_deltaReal -
+                                    step->bImaginary * p_deltaImaginary;
+            dImaginary = step->aReal * dImaginary + step->aImaginary * dReal + step->bReal * p_deltaImaginary +
+                         step->bImaginary * p_deltaReal;
+            dReal = nextReal;
+            i += step->length;
+            m += step->length;
+            p_statistics.skippedIterations += step->length;
+            continue;
+        }
+
+        // d' = 2 * Z * d + d^2 + dc
+        const double nextReal = 2.0 * (referenceReal * dReal - referenceImaginary * dImaginary) +
+                                (dReal * dReal - dImaginary * dImaginary) + p_deltaReal;
+        dImaginary = 2.0 * (referenceReal * dImaginary + referenceImaginary * dReal) + 2.0 * dReal * dImaginary +
+                     p_deltaImaginary;
+        dReal = nextReal;
+        i++;
+        m++;
+    }
+    return static_cast<uint32_t>(i);
+}
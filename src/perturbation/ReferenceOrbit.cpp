@@ -0,0 +1,48 @@
+#include <perturbation/ReferenceOrbit.hpp>
+
+#include <algorithm>
+
+void ReferenceOrbit::compute(const FixedPoint& p_real, const FixedPoint& p_imaginary, int p_maxIterations) {
+    _real = p_real;
+    _imaginary = p_imaginary;
+    _maxIterations = p_maxIterations;
+    _escaped = false;
+    _values.clear();
+    _values.reserve(2 * (static_cast<size_t>(p_maxIterations) + 1));
+
+    const int fractionLimbs = std::max(p_real.getFractionLimbs(), p_imaginary.getFractionLimbs());
+    FixedPoint zReal(fractionLimbs);
+    FixedPoint zImaginary(fractionLimbs);
+
+    // Reused every iteration, so the loop doesn't allocate
+    FixedPoint zReal2(fractionLimbs);
+    FixedPoint zImaginary2(fractionLimbs);
+    FixedPoint sum(fractionLimbs);
+    std::vector<uint64_t> scratch;
+
+    for (int i = 0; i <= p_maxIterations; i++) {
+        const double real = zReal.toDouble();
+        const double imaginary = zImaginary.toDouble();
+        _values.push_back(real);
+        _values.push_back(imaginary);
+
+        if (real * real + imaginary * imaginary > 4.0) {
+            _escaped = true;
+            return;
+        }
+
+        // Three squarings instead of two squarings and a multiplication: 2 * zr * zi = (zr + zi)^2 - zr^2 - zi^2
+        zReal2.assignSquare(zReal, scratch);
+        zImaginary2.assignSquare(zImaginary, scratch);
+        sum = zReal;
+        sum += zImaginary;
+        zImaginary.assignSquare(sum, scratch);
+        zImaginary -= zReal2;
+        zImaginary -= zImaginary2;
+        zImaginary += p_imaginary;
+
+        zReal = zReal2;
+        zReal -= zImaginary2;
+        zReal += p_real;
+    }
+}
@@ -0,0 +1,467 @@
+#include <precision/FixedPoint.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if !defined(__SIZEOF_INT128__) && defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace {
+    // Below this many limbs schoolbook beats Karatsuba (~4000 bits, zooms beyond 1e-1200)
+    constexpr size_t karatsubaThreshold = 64;
+
+    // p_a * p_b + p_add + p_carry, returns the low 64 bits and stores the high 64 bits in p_carry (never overflows)
+    inline uint64_t multiplyAdd(uint64_t p_a, uint64_t p_b, uint64_t p_add, uint64_t& p_carry) {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 t = static_cast<unsigned __int128>(p_a) * p_b + p_add + p_carry;
+        p_carry = static_cast<uint64_t>(t >> 64);
+        return static_cast<uint64_t>(t);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t high;
+        uint64_t low = _umul128(p_a, p_b, &high);
+        low += p_add;
+        high += low < p_add;
+        low += p_carry;
+        high += low < p_carry;
+        p_carry = high;
+        return low;
+#else
+        // Portable fallback with 32-bit halves
+        const uint64_t aLow = p_a & 0xFFFFFFFFu, aHigh = p_a >> 32;
+        const uint64_t bLow = p_b & 0xFFFFFFFFu, bHigh = p_b >> 32;
+        const uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+        const uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFu) + (highLow & 0xFFFFFFFFu);
+        uint64_t low = (middle << 32) | (lowLow & 0xFFFFFFFFu);
+        uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+        low += p_add;
+        high += low < p_add;
+        low += p_carry;
+        high += low < p_carry;
+        p_carry = high;
+        return low;
+#endif
+    }
+
+    // p_a += p_b (p_bSize <= p_aSize), returns the carry out of p_a
+    uint64_t addInPlace(uint64_t* p_a, size_t p_aSize, const uint64_t* p_b, size_t p_bSize) {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < p_aSize; i++) {
+            if (i >= p_bSize && !carry) break;
+            const uint64_t b = i < p_bSize ? p_b[i] : 0;
+            const uint64_t sum = p_a[i] + b;
+            const uint64_t nextCarry = sum < b;
+            p_a[i] = sum + carry;
+            carry = nextCarry | (p_a[i] < carry);
+        }
+        return carry;
+    }
+
+    // p_a -= p_b (p_bSize <= p_aSize, p_a >= p_b)
+    void subtractInPlace(uint64_t* p_a, size_t p_aSize, const uint64_t* p_b, size_t p_bSize) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < p_aSize; i++) {
+            if (i >= p_bSize && !borrow) break;
+            const uint64_t b = i < p_bSize ? p_b[i] : 0;
+            const uint64_t difference = p_a[i] - b;
+            const uint64_t nextBorrow = p_a[i] < b;
+            p_a[i] = difference - borrow;
+            borrow = nextBorrow | (difference < borrow);
+        }
+    }
+
+    // p_a = p_b - p_a (equal sizes, p_b >= p_a)
+    void reverseSubtractInPlace(uint64_t* p_a, const uint64_t* p_b, size_t p_size) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < p_size; i++) {
+            const uint64_t difference = p_b[i] - p_a[i];
+            const uint64_t nextBorrow = p_b[i] < p_a[i];
+            p_a[i] = difference - borrow;
+            borrow = nextBorrow | (difference < borrow);
+        }
+    }
+
+    void schoolbookMultiply(const uint64_t* p_a, const uint64_t* p_b, size_t p_size, uint64_t* p_result) {
+        std::fill(p_result, p_result + 2 * p_size, 0);
+        for (size_t i = 0; i < p_size; i++) {
+            if (p_a[i] == 0) continue;
+            uint64_t carry = 0;
+            for (size_t j = 0; j < p_size; j++) {
+                p_result[i + j] = multiplyAdd(p_a[i], p_b[j], p_result[i + j], carry);
+            }
+            p_result[i + p_size] = carry;
+        }
+    }
+
+    void schoolbookSquare(const uint64_t* p_a, size_t p_size, uint64_t* p_result) {
+        std::fill(p_result, p_result + 2 * p_size, 0);
+
+        // Products above the diagonal, each one stands for two
+        for (size_t i = 0; i < p_size; i++) {
+            if (p_a[i] == 0) continue;
+            uint64_t carry = 0;
+            for (size_t j = i + 1; j < p_size; j++) {
+                p_result[i + j] = multiplyAdd(p_a[i], p_a[j], p_result[i + j], carry);
+            }
+            p_result[i + p_size] = carry;
+        }
+
+        // Double them
+        uint64_t shifted = 0;
+        for (size_t i = 0; i < 2 * p_size; i++) {
+            const uint64_t next = p_result[i] >> 63;
+            p_result[i] = (p_result[i] << 1) | shifted;
+            shifted = next;
+        }
+
+        // Add the squares on the diagonal
+        uint64_t carry = 0;
+        for (size_t i = 0; i < p_size; i++) {
+            uint64_t high = 0;
+            const uint64_t low = multiplyAdd(p_a[i], p_a[i], 0, high);
+
+            uint64_t sum = p_result[2 * i] + low;
+            uint64_t nextCarry = sum < low;
+            p_result[2 * i] = sum + carry;
+            nextCarry += p_result[2 * i] < carry;
+
+            sum = p_result[2 * i + 1] + high;
+            uint64_t overflow = sum < high;
+            p_result[2 * i + 1] = sum + nextCarry;
+            overflow += p_result[2 * i + 1] < nextCarry;
+            carry = overflow;
+        }
+    }
+
+    // Scratch limbs needed by karatsuba() for operands of p_size limbs
+    size_t karatsubaWorkspace(size_t p_size) {
+        if (p_size < karatsubaThreshold) return 0;
+        const size_t high = p_size - p_size / 2;
+        return 10 * high + 4 + karatsubaWorkspace(high + 1);
+    }
+
+    /**
+     * Karatsuba: a * b = z2 * B^2h + ((a0 + a1)(b0 + b1) - z0 - z2) * B^h + z0
+     * A null p_b squares p_a (the three partial products become squares as well).
+     * p_workspace must hold karatsubaWorkspace(p_size) limbs.
+     */
+    void karatsuba(const uint64_t* p_a, const uint64_t* p_b, size_t p_size, uint64_t* p_result, uint64_t* p_workspace) {
+        const bool squaring = p_b == nullptr;
+        if (p_size < karatsubaThreshold) {
+            if (squaring) {
+                schoolbookSquare(p_a, p_size, p_result);
+            } else {
+                schoolbookMultiply(p_a, p_b, p_size, p_result);
+            }
+            return;
+        }
+
+        const size_t low = p_size / 2;
+        const size_t high = p_size - low;
+
+        uint64_t* lowA = p_workspace;
+        uint64_t* lowB = lowA + high;
+        uint64_t* z0 = lowB + high;
+        uint64_t* z2 = z0 + 2 * high;
+        uint64_t* sumA = z2 + 2 * high;
+        uint64_t* sumB = sumA + high + 1;
+        uint64_t* z1 = sumB + high + 1;
+        uint64_t* next = z1 + 2 * (high + 1);
+
+        // Low halves, padded to the size of the high halves
+        std::fill(lowA, lowA + 2 * high, 0);
+        std::copy(p_a, p_a + low, lowA);
+        if (!squaring) std::copy(p_b, p_b + low, lowB);
+
+        // z0 = a0 * b0, z2 = a1 * b1
+        karatsuba(lowA, squaring ? nullptr : lowB, high, z0, next);
+        karatsuba(p_a + low, squaring ? nullptr : p_b + low, high, z2, next);
+
+        // z1 = (a0 + a1)(b0 + b1) - z0 - z2
+        std::copy(p_a + low, p_a + p_size, sumA);
+        sumA[high] = addInPlace(sumA, high, lowA, high);
+        if (!squaring) {
+            std::copy(p_b + low, p_b + p_size, sumB);
+            sumB[high] = addInPlace(sumB, high, lowB, high);
+        }
+        karatsuba(sumA, squaring ? nullptr : sumB, high + 1, z1, next);
+        subtractInPlace(z1, 2 * (high + 1), z0, 2 * high);
+        subtractInPlace(z1, 2 * (high + 1), z2, 2 * high);
+
+        // Combine, the limbs beyond 2 * p_size are zero
+        std::fill(p_result, p_result + 2 * p_size, 0);
+        std::copy(z0, z0 + 2 * low, p_result);
+        addInPlace(p_result + 2 * low, 2 * p_size - 2 * low, z2, 2 * p_size - 2 * low);
+        addInPlace(p_result + low, 2 * p_size - low, z1, std::min(2 * (high + 1), 2 * p_size - low));
+    }
+
+    void multiplyFull(const uint64_t* p_a, const uint64_t* p_b, size_t p_size, uint64_t* p_result) {
+        if (p_size < karatsubaThreshold) {
+            karatsuba(p_a, p_b, p_size, p_result, nullptr);
+            return;
+        }
+        std::vector<uint64_t> workspace(karatsubaWorkspace(p_size));
+        karatsuba(p_a, p_b, p_size, p_result, workspace.data());
+    }
+}
+
+FixedPoint::FixedPoint(int p_fractionLimbs) : _limbs(std::max(p_fractionLimbs, 0) + 1, 0) {}
+
+FixedPoint::FixedPoint(double p_value, int p_fractionLimbs) : FixedPoint(p_fractionLimbs) {
+    _negative = p_value < 0.0;
+
+    // Every step is exact: scaling by 2^64 and removing the integer part don't round
+    double remainder = std::fabs(p_value);
+    const double integer = std::floor(remainder);
+    _limbs.back() = static_cast<uint64_t>(integer);
+    remainder -= integer;
+
+    for (int i = static_cast<int>(_limbs.size()) - 2; i >= 0 && remainder > 0.0; i--) {
+        remainder *= 18446744073709551616.0;
+        const double limb = std::floor(remainder);
+        _limbs[i] = static_cast<uint64_t>(limb);
+        remainder -= limb;
+    }
+}
+
+FixedPoint::FixedPoint(const FloatExp& p_value, int p_fractionLimbs) : FixedPoint(p_fractionLimbs) {
+    if (p_value.isZero()) return;
+    _negative = p_value.mantissa < 0.0;
+
+    // 53-bit integer significand, its lowest bit has the weight 2^(exponent - 52)
+    uint64_t significand = static_cast<uint64_t>(std::ldexp(std::fabs(p_value.mantissa), 52));
+    int64_t position = p_value.exponent - 52 + 64 * static_cast<int64_t>(getFractionLimbs());
+    if (position < 0) {
+        significand = position > -64 ? significand >> -position : 0;
+        position = 0;
+    }
+
+    const size_t limb = static_cast<size_t>(position / 64);
+    const int shift = static_cast<int>(position % 64);
+    if (limb < _limbs.size()) _limbs[limb] = significand << shift;
+    if (shift > 0 && limb + 1 < _limbs.size()) _limbs[limb + 1] = significand >> (64 - shift);
+}
+
+double FixedPoint::toDouble() const {
+    // The two most significant non-zero limbs cover 53 bits
+    const int fractionLimbs = getFractionLimbs();
+    int top = static_cast<int>(_limbs.size()) - 1;
+    while (top > 0 && _limbs[top] == 0) top--;
+
+    double value = 0.0;
+    for (int i = top; i >= 0 && i > top - 2; i--) {
+        value += std::ldexp(static_cast<double>(_limbs[i]), 64 * (i - fractionLimbs));
+    }
+    return _negative ? -value : value;
+}
+
+FloatExp FixedPoint::toFloatExp() const {
+    const int fractionLimbs = getFractionLimbs();
+    int top = static_cast<int>(_limbs.size()) - 1;
+    while (top > 0 && _limbs[top] == 0) top--;
+
+    // The top two limbs relative to the weight of the top limb never underflow
+    double value = static_cast<double>(_limbs[top]);
+    if (top > 0) value += std::ldexp(static_cast<double>(_limbs[top - 1]), -64);
+    return FloatExp::normalized(_negative ? -value : value, 64 * static_cast<int64_t>(top - fractionLimbs));
+}
+
+std::string FixedPoint::toString(int p_digits) const {
+    std::string result = _negative && !isZero() ? "-" : "";
+    result += std::to_string(_limbs.back());
+    result += '.';
+
+    // Multiply the fraction by 10, the overflow into the integer limb is the next digit
+    std::vector<uint64_t> fraction(_limbs.begin(), _limbs.end() - 1);
+    for (int digit = 0; digit < p_digits; digit++) {
+        uint64_t carry = 0;
+        for (uint64_t& limb : fraction) { limb = multiplyAdd(limb, 10, 0, carry); }
+        result += static_cast<char>('0' + carry);
+    }
+    return result;
+}
+
+FixedPoint FixedPoint::fromString(const std::string& p_text, int p_fractionLimbs) {
+    const size_t sign = !p_text.empty() && (p_text[0] == '-' || p_text[0] == '+') ? 1 : 0;
+    const size_t point = std::min(p_text.find('.'), p_text.size());
+    const bool valid = point + 1 < p_text.size() || point > sign;
+    if (!valid || p_text.find_first_not_of("0123456789", sign) < point ||
+        (point < p_text.size() && p_text.find_first_not_of("0123456789", point + 1) != std::string::npos)) {
+        throw std::invalid_argument("Not a decimal number: " + p_text);
+    }
+
+    // One guard limb, so the truncation of the divisions doesn't reach the kept limbs
+    FixedPoint result(p_fractionLimbs + 1);
+    result._negative = p_text[0] == '-';
+
+    // Fraction digits from the last one: fraction = (digit + fraction) / 10
+    for (size_t i = p_text.size(); i > point + 1; i--) {
+        result._limbs.back() = static_cast<uint64_t>(p_text[i - 1] - '0');
+        uint64_t remainder = 0;
+        for (auto limb = result._limbs.rbegin(); limb != result._limbs.rend(); ++limb) {
+            // In 32-bit halves, the remainder is below 10
+            const uint64_t high = remainder << 32 | *limb >> 32;
+            const uint64_t low = (high % 10) << 32 | (*limb & 0xFFFFFFFFu);
+            *limb = (high / 10) << 32 | low / 10;
+            remainder = low % 10;
+        }
+    }
+
+    uint64_t integer = 0;
+    for (size_t i = sign; i < point; i++) { integer = integer * 10 + static_cast<uint64_t>(p_text[i] - '0'); }
+    result._limbs.back() = integer;
+    result.setFractionLimbs(p_fractionLimbs);
+    return result;
+}
+
+void FixedPoint::setFractionLimbs(int p_fractionLimbs) {
+    const int difference = std::max(p_fractionLimbs, 0) - getFractionLimbs();
+    if (difference > 0) {
+        _limbs.insert(_limbs.begin(), difference, 0);
+    } else if (difference < 0) {
+        _limbs.erase(_limbs.begin(), _limbs.begin() - difference);
+    }
+}
+
+int FixedPoint::fractionLimbsFor(const FloatExp& p_resolution) {
+    // 64 guard bits absorb the truncation error accumulated over the iteration
+    const int64_t exponent = p_resolution.isZero() ? 0 : p_resolution.exponent;
+    return static_cast<int>(std::max<int64_t>(1, (-exponent + 64 + 63) / 64));
+}
+
+bool FixedPoint::isZero() const {
+    return std::all_of(_limbs.begin(), _limbs.end(), [](uint64_t p_limb) { return p_limb == 0; });
+}
+
+FixedPoint FixedPoint::operator-() const {
+    FixedPoint result = *this;
+    result._negative = !_negative;
+    return result;
+}
+
+FixedPoint FixedPoint::operator+(const FixedPoint& p_other) const {
+    FixedPoint result = *this;
+    return result.accumulate(p_other, false);
+}
+
+FixedPoint FixedPoint::operator-(const FixedPoint& p_other) const {
+    FixedPoint result = *this;
+    return result.accumulate(p_other, true);
+}
+
+FixedPoint FixedPoint::operator*(const FixedPoint& p_other) const {
+    const int fractionLimbs = std::max(getFractionLimbs(), p_other.getFractionLimbs());
+    const FixedPoint a = withFractionLimbs(fractionLimbs);
+    const FixedPoint b = p_other.withFractionLimbs(fractionLimbs);
+
+    std::vector<uint64_t> product(2 * a._limbs.size());
+    multiplyMagnitudes(a._limbs.data(), b._limbs.data(), a._limbs.size(), product.data());
+    return fromProduct(product, fractionLimbs, a._negative != b._negative);
+}
+
+FixedPoint FixedPoint::square() const {
+    FixedPoint result;
+    std::vector<uint64_t> scratch;
+    result.assignSquare(*this, scratch);
+    return result;
+}
+
+void FixedPoint::assignSquare(const FixedPoint& p_value, std::vector<uint64_t>& p_scratch) {
+    const size_t size = p_value._limbs.size();
+    p_scratch.resize(2 * size);
+    squareMagnitude(p_value._limbs.data(), size, p_scratch.data());
+
+    // Drop the lowest fractionLimbs limbs and everything above the integer limb
+    _limbs.resize(size);
+    std::copy(p_scratch.begin() + (size - 1), p_scratch.begin() + (2 * size - 1), _limbs.begin());
+    _negative = false;
+}
+
+bool FixedPoint::operator==(const FixedPoint& p_other) const {
+    const int fractionLimbs = std::max(getFractionLimbs(), p_other.getFractionLimbs());
+    const FixedPoint a = withFractionLimbs(fractionLimbs);
+    const FixedPoint b = p_other.withFractionLimbs(fractionLimbs);
+    if (a.isZero() && b.isZero()) return true;
+    return a._negative == b._negative && a._limbs == b._limbs;
+}
+
+FixedPoint FixedPoint::twice() const {
+    FixedPoint result = *this;
+    uint64_t carry = 0;
+    for (uint64_t& limb : result._limbs) {
+        const uint64_t next = limb >> 63;
+        limb = (limb << 1) | carry;
+        carry = next;
+    }
+    return result;
+}
+
+FixedPoint FixedPoint::half() const {
+    FixedPoint result = *this;
+    uint64_t carry = 0;
+    for (size_t i = result._limbs.size(); i-- > 0;) {
+        const uint64_t next = result._limbs[i] << 63;
+        result._limbs[i] = (result._limbs[i] >> 1) | carry;
+        carry = next;
+    }
+    return result;
+}
+
+void FixedPoint::multiplyMagnitudes(const uint64_t* p_a, const uint64_t* p_b, size_t p_size, uint64_t* p_result) {
+    multiplyFull(p_a, p_b, p_size, p_result);
+}
+
+void FixedPoint::squareMagnitude(const uint64_t* p_a, size_t p_size, uint64_t* p_result) {
+    multiplyFull(p_a, nullptr, p_size, p_result);
+}
+
+int FixedPoint::compareMagnitude(const std::vector<uint64_t>& p_a, const std::vector<uint64_t>& p_b) {
+    for (size_t i = p_a.size(); i-- > 0;) {
+        if (p_a[i] != p_b[i]) return p_a[i] < p_b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+void FixedPoint::addMagnitude(std::vector<uint64_t>& p_a, const std::vector<uint64_t>& p_b) {
+    addInPlace(p_a.data(), p_a.size(), p_b.data(), p_b.size());
+}
+
+void FixedPoint::subtractMagnitude(std::vector<uint64_t>& p_a, const std::vector<uint64_t>& p_b) {
+    subtractInPlace(p_a.data(), p_a.size(), p_b.data(), p_b.size());
+}
+
+FixedPoint& FixedPoint::accumulate(const FixedPoint& p_other, bool p_subtract) {
+    if (p_other.getFractionLimbs() < getFractionLimbs()) {
+        return accumulate(p_other.withFractionLimbs(getFractionLimbs()), p_subtract);
+    }
+    setFractionLimbs(p_other.getFractionLimbs());
+
+    const bool otherNegative = p_other._negative != p_subtract;
+    if (_negative == otherNegative) {
+        addMagnitude(_limbs, p_other._limbs);
+    } else if (compareMagnitude(_limbs, p_other._limbs) >= 0) {
+        subtractMagnitude(_limbs, p_other._limbs);
+    } else {
+        reverseSubtractInPlace(_limbs.data(), p_other._limbs.data(), _limbs.size());
+        _negative = otherNegative;
+    }
+    return *this;
+}
+
+FixedPoint FixedPoint::withFractionLimbs(int p_fractionLimbs) const {
+    if (p_fractionLimbs <= getFractionLimbs()) return *this;
+    FixedPoint result = *this;
+    result.setFractionLimbs(p_fractionLimbs);
+    return result;
+}
+
+FixedPoint FixedPoint::fromProduct(const std::vector<uint64_t>& p_product, int p_fractionLimbs, bool p_negative) {
+    // Drop the lowest fractionLimbs limbs and everything above the integer limb
+    FixedPoint result(p_fractionLimbs);
+    std::copy(p_product.begin() + p_fractionLimbs,
+              p_product.begin() + p_fractionLimbs + result._limbs.size(),
+              result._limbs.begin());
+    result._negative = p_negative;
+    return result;
+}